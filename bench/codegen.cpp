@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "artic/log.h"
+
+using namespace artic;
+
+static void usage() {
+    std::cout << "usage: bench_codegen [options] benchmarks...\n"
+                 "Runs programs generated by the compiler and measures their median running time, their peak\n"
+                 "memory usage, and the size of their executable. Each benchmark is given as\n"
+                 "'name:executable[:arguments]', where the arguments are separated by spaces.\n"
+                 "options:\n"
+                 "  -n <runs>        Number of times each program is run (defaults to 5)\n"
+                 "  -o <file>        Writes the results to a CSV file, or to a JSON file if the name ends with '.json'\n"
+                 "  -b <file>        Compares the results with a baseline CSV file written with -o\n"
+                 "  -t <percent>     Tolerance when comparing with the baseline (defaults to 5%)\n";
+}
+
+struct Benchmark {
+    std::string name;
+    std::string executable;
+    std::vector<std::string> args;
+};
+
+struct Result {
+    std::string name;
+    double median_ms = 0;
+    size_t peak_rss_kb = 0;
+    size_t binary_size = 0;
+};
+
+static bool parse_benchmark(const std::string& spec, Benchmark& benchmark) {
+    auto first = spec.find(':');
+    if (first == std::string::npos || first == 0)
+        return false;
+    auto second = spec.find(':', first + 1);
+    benchmark.name = spec.substr(0, first);
+    benchmark.executable = spec.substr(first + 1, second == std::string::npos ? std::string::npos : second - first - 1);
+    if (second != std::string::npos) {
+        std::istringstream is(spec.substr(second + 1));
+        std::string arg;
+        while (is >> arg)
+            benchmark.args.push_back(arg);
+    }
+    return !benchmark.executable.empty();
+}
+
+// Runs the program once, with its output discarded, and returns false if it fails
+static bool run(const Benchmark& benchmark, double& seconds, size_t& peak_rss_kb) {
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(benchmark.executable.c_str()));
+    for (auto& arg : benchmark.args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    auto pid = fork();
+    if (pid < 0)
+        return false;
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        if (null_fd >= 0)
+            dup2(null_fd, STDOUT_FILENO);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return false;
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    peak_rss_kb = usage.ru_maxrss;
+    return true;
+}
+
+static bool measure(const Benchmark& benchmark, size_t runs, Result& result) {
+    struct stat st;
+    if (stat(benchmark.executable.c_str(), &st) != 0) {
+        log::error("cannot find executable '{}'", benchmark.executable);
+        return false;
+    }
+    result.name = benchmark.name;
+    result.binary_size = st.st_size;
+
+    std::vector<double> times;
+    for (size_t i = 0; i < runs; ++i) {
+        double seconds = 0;
+        size_t peak_rss_kb = 0;
+        if (!run(benchmark, seconds, peak_rss_kb)) {
+            log::error("benchmark '{}' failed", benchmark.name);
+            return false;
+        }
+        times.push_back(seconds);
+        result.peak_rss_kb = std::max(result.peak_rss_kb, peak_rss_kb);
+    }
+    std::sort(times.begin(), times.end());
+    auto n = times.size();
+    result.median_ms = (n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2) * 1.0e3;
+    return true;
+}
+
+static void write_csv(std::ostream& os, const std::vector<Result>& results) {
+    os << "name,median_ms,peak_rss_kb,binary_size\n" << std::fixed << std::setprecision(3);
+    for (auto& result : results)
+        os << result.name << "," << result.median_ms << "," << result.peak_rss_kb << "," << result.binary_size << "\n";
+}
+
+static void write_json(std::ostream& os, const std::vector<Result>& results) {
+    os << "[" << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < results.size(); ++i) {
+        os << (i > 0 ? ",\n" : "\n")
+           << "  { \"name\": \"" << results[i].name << "\""
+           << ", \"median_ms\": " << results[i].median_ms
+           << ", \"peak_rss_kb\": " << results[i].peak_rss_kb
+           << ", \"binary_size\": " << results[i].binary_size << " }";
+    }
+    os << "\n]\n";
+}
+
+static bool read_csv(const std::string& file, std::vector<Result>& results) {
+    std::ifstream is(file);
+    if (!is)
+        return false;
+    std::string line;
+    std::getline(is, line);
+    while (std::getline(is, line)) {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream ls(line);
+        Result result;
+        if (ls >> result.name >> result.median_ms >> result.peak_rss_kb >> result.binary_size)
+            results.push_back(result);
+    }
+    return true;
+}
+
+// Returns the number of results that are worse than their baseline by more than the given tolerance
+static size_t compare(const std::vector<Result>& results, const std::vector<Result>& baseline, double tolerance) {
+    size_t regressions = 0;
+    auto check = [&] (const std::string& name, const char* what, double value, double base) {
+        auto change = base > 0 ? (value - base) / base * 100.0 : 0.0;
+        if (change > tolerance) {
+            std::cout << "regression: " << name << ": " << what << " increased by "
+                      << std::fixed << std::setprecision(1) << change << "% ("
+                      << std::setprecision(3) << base << " -> " << value << ")\n";
+            regressions++;
+        }
+    };
+    for (auto& result : results) {
+        auto it = std::find_if(baseline.begin(), baseline.end(), [&] (const Result& base) {
+            return base.name == result.name;
+        });
+        if (it == baseline.end()) {
+            std::cout << "note: " << result.name << " is not in the baseline\n";
+            continue;
+        }
+        check(result.name, "median time (ms)", result.median_ms, it->median_ms);
+        check(result.name, "peak memory (KB)", double(result.peak_rss_kb), double(it->peak_rss_kb));
+        check(result.name, "binary size (bytes)", double(result.binary_size), double(it->binary_size));
+    }
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    std::vector<Benchmark> benchmarks;
+    std::string output, baseline_file;
+    size_t runs = 5;
+    double tolerance = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            runs = std::strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            output = argv[++i];
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+            baseline_file = argv[++i];
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            tolerance = std::strtod(argv[++i], nullptr);
+        else if (argv[i][0] == '-') {
+            usage();
+            return EXIT_FAILURE;
+        } else {
+            Benchmark benchmark;
+            if (!parse_benchmark(argv[i], benchmark)) {
+                log::error("invalid benchmark '{}'", argv[i]);
+                return EXIT_FAILURE;
+            }
+            benchmarks.push_back(std::move(benchmark));
+        }
+    }
+    if (benchmarks.empty() || runs == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    // The baseline is read before any result is written, since it may be the same file as the output
+    std::vector<Result> baseline;
+    if (!baseline_file.empty() && !read_csv(baseline_file, baseline)) {
+        log::error("cannot open baseline '{}'", baseline_file);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Result> results;
+    size_t width = 4;
+    for (auto& benchmark : benchmarks)
+        width = std::max(width, benchmark.name.size() + 2);
+    std::cout << std::left << std::setw(width) << "name" << std::right
+              << std::setw(14) << "median (ms)" << std::setw(14) << "peak (KB)" << std::setw(14) << "size (B)" << "\n";
+    for (auto& benchmark : benchmarks) {
+        Result result;
+        if (!measure(benchmark, runs, result))
+            return EXIT_FAILURE;
+        std::cout << std::left << std::setw(width) << result.name << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(14) << result.median_ms
+                  << std::setw(14) << result.peak_rss_kb << std::setw(14) << result.binary_size << std::endl;
+        results.push_back(result);
+    }
+
+    if (!output.empty()) {
+        std::ofstream os(output);
+        if (!os) {
+            log::error("cannot open '{}' for writing", output);
+            return EXIT_FAILURE;
+        }
+        auto is_json = output.size() >= 5 && output.compare(output.size() - 5, 5, ".json") == 0;
+        if (is_json)
+            write_json(os, results);
+        else
+            write_csv(os, results);
+    }
+
+    if (!baseline_file.empty()) {
+        if (auto regressions = compare(results, baseline, tolerance)) {
+            std::cout << regressions << " regression(s) compared to '" << baseline_file << "'\n";
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
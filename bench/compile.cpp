@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <thorin/world.h>
+
+#include "artic/emit.h"
+#include "artic/stats.h"
+#include "artic/log.h"
+
+using namespace artic;
+
+static void usage() {
+    std::cout << "usage: bench_compile [options] [kinds...]\n"
+                 "Measures the time taken by each pass of the compiler on generated programs of increasing size,\n"
+                 "and reports how each pass scales with the size of the program. Passes that scale worse than\n"
+                 "O(n^1.5) are marked with '!' and reported with a warning. The available kinds of programs are:\n"
+                 "  functions  Thousands of functions calling each other\n"
+                 "  nesting    Deeply nested blocks and conditionals\n"
+                 "  enums      Wide enumerations with large `match` expressions\n"
+                 "  generics   Deeply nested generic structures and polymorphic functions, instantiated many times\n"
+                 "  strings    Long string literals\n"
+                 "options:\n"
+                 "  -n <iterations>  Number of times each program is compiled after a first, untimed compilation\n"
+                 "                   (defaults to 5, the median time of each pass is kept)\n"
+                 "  -s <steps>       Number of sizes for each kind, each twice as large as the previous one (defaults to 4)\n"
+                 "  -m <factor>      Multiplies the size of the first program by the given factor (defaults to 1)\n"
+                 "  -p <kind> <size> Prints the generated program of the given kind and size, and exits\n"
+                 "  --json           Prints the results as JSON\n"
+                 "  --strict         Fails when a pass scales worse than O(n^1.5), instead of only warning\n";
+}
+
+// Generators ----------------------------------------------------------------------
+
+static std::string functions(size_t n) {
+    std::ostringstream os;
+    os << "#[export]\nfn f0(x: i32) -> i32 { x }\n"
+          "#[export]\nfn f1(x: i32) -> i32 { x + 1 }\n";
+    for (size_t i = 2; i < n; ++i) {
+        os << "#[export]\nfn f" << i << "(x: i32) -> i32 {\n"
+              "    let y = f" << i - 1 << "(x) * 2;\n"
+              "    let z = f" << i - 2 << "(y);\n"
+              "    if y > z { y - z } else { z }\n"
+              "}\n";
+    }
+    return os.str();
+}
+
+static std::string nesting(size_t n) {
+    std::ostringstream os;
+    os << "#[export]\nfn nesting(x: i32) -> i32 {\n    let mut a = x;\n";
+    for (size_t i = 0; i < n; ++i)
+        os << "if a > " << i << " { a += " << i % 7 << "; { let b = a * 2; a = b - a; } ";
+    for (size_t i = 0; i < n; ++i)
+        os << (i % 2 == 0 ? "}" : "} else { a -= 1; }");
+    os << "\n    a\n}\n";
+    return os.str();
+}
+
+static std::string enums(size_t n) {
+    std::ostringstream os;
+    os << "enum E {\n";
+    for (size_t i = 0; i < n; ++i) {
+        switch (i % 3) {
+            case 0:  os << "    V" << i << ",\n"; break;
+            case 1:  os << "    V" << i << "(i32),\n"; break;
+            default: os << "    V" << i << "(i32, (bool, i32)),\n"; break;
+        }
+    }
+    os << "}\n#[export]\nfn enums(e: E, x: i32) -> i32 {\n    let y = match e {\n";
+    for (size_t i = 0; i < n; ++i) {
+        switch (i % 3) {
+            case 0:  os << "        E::V" << i << " => " << i << ",\n"; break;
+            case 1:  os << "        E::V" << i << "(a) => a + " << i << ",\n"; break;
+            default: os << "        E::V" << i << "(a, (true, b)) => a * b,\n"
+                        << "        E::V" << i << "(_, (false, b)) => b,\n"; break;
+        }
+    }
+    os << "    };\n    match x {\n";
+    for (size_t i = 0; i < n; ++i)
+        os << "        " << i << " => y + " << i % 5 << ",\n";
+    os << "        _ => y\n    }\n}\n";
+    return os.str();
+}
+
+static std::string generics(size_t n) {
+    // The depth of the structures is fixed, so that the size of the types does not grow with `n`
+    static constexpr size_t depth = 16;
+    std::ostringstream os;
+    os << "struct G0[T] { x: T }\n"
+          "fn get0[T](g: G0[T]) -> T { g.x }\n";
+    for (size_t i = 1; i < depth; ++i) {
+        os << "struct G" << i << "[T, U] { x: G" << i - 1 << (i > 1 ? "[T, U]" : "[T]") << ", y: U }\n"
+           << "fn get" << i << "[T, U](g: G" << i << "[T, U]) -> T { get" << i - 1 << "(g.x) }\n";
+    }
+    // Every function instantiates the structures and functions above with different types
+    for (size_t i = 0; i < n; ++i) {
+        os << "#[export]\nfn generics" << i << "(g: G" << depth - 1 << "[[i32 * " << i + 1 << "], (i64, [f32 * " << i % 8 + 1 << "])]) -> i32 {\n"
+              "    get" << depth - 1 << "(g)(" << i << ")\n}\n";
+    }
+    return os.str();
+}
+
+static std::string strings(size_t n) {
+    static constexpr size_t string_count = 16;
+    std::ostringstream os;
+    for (size_t i = 0; i < string_count; ++i) {
+        os << "#[export]\nfn string" << i << "(j: i64) -> u8 {\n    let s = \"";
+        for (size_t j = 0; j < n; ++j)
+            os << (j % 64 == 63 ? "\\n" : std::string(1, char('a' + (i + j) % 26)));
+        os << "\";\n    s(j)\n}\n";
+    }
+    return os.str();
+}
+
+struct Kind {
+    const char* name;
+    std::string (*generate)(size_t);
+    size_t size;
+};
+
+static const Kind kinds[] = {
+    { "functions", functions, 1000 },
+    { "nesting",   nesting,   100  },
+    { "enums",     enums,     200  },
+    { "generics",  generics,  100  },
+    { "strings",   strings,   10000 },
+};
+
+// Measurements --------------------------------------------------------------------
+
+struct Result {
+    size_t size;
+    std::vector<Stats::Pass> passes;
+};
+
+static double median(std::vector<double>& values) {
+    std::sort(values.begin(), values.end());
+    auto n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+// Compiles the program once to warm up caches and the allocator, then several
+// more times, and keeps the median time of each pass, which is less sensitive
+// to noise than a single run
+static bool measure(const std::string& source, size_t iterations, Result& result) {
+    std::ostream null_stream(nullptr);
+    log::Output null_out(null_stream, false);
+    std::vector<std::vector<double>> walls, cpus;
+    for (size_t i = 0; i <= iterations; ++i) {
+        Log log(null_out);
+        Stats stats;
+        stats.time_passes = true;
+        thorin::World world("bench");
+        ast::ModDecl program;
+        if (!compile({ "bench.art" }, { std::string_view(source) }, false, false, false, program, world, thorin::Log::Error, log, &stats))
+            return false;
+        if (i == 0) {
+            result.passes = stats.passes;
+            walls.resize(result.passes.size());
+            cpus.resize(result.passes.size());
+            continue;
+        }
+        for (size_t j = 0, n = std::min(stats.passes.size(), result.passes.size()); j < n; ++j) {
+            walls[j].push_back(stats.passes[j].wall);
+            cpus[j].push_back(stats.passes[j].cpu);
+        }
+    }
+    for (size_t j = 0; j < result.passes.size() && !walls[j].empty(); ++j) {
+        result.passes[j].wall = median(walls[j]);
+        result.passes[j].cpu  = median(cpus[j]);
+    }
+    return true;
+}
+
+// Returns the exponent `k` such that the time of the given pass grows like `O(n^k)` between the two results,
+// or NaN if the pass is too fast to be measured reliably.
+static double scaling(const Result& first, const Result& last, size_t pass) {
+    static constexpr double min_time = 1.0e-4;
+    auto t0 = first.passes[pass].wall, t1 = last.passes[pass].wall;
+    if (t0 < min_time || t1 < min_time || last.size == first.size)
+        return std::numeric_limits<double>::quiet_NaN();
+    return std::log(t1 / t0) / std::log(double(last.size) / double(first.size));
+}
+
+static constexpr double max_scaling = 1.5;
+
+static void print_text(const Kind& kind, const std::vector<Result>& results) {
+    auto& passes = results.front().passes;
+    std::cout << kind.name << "\n"
+              << std::setw(10) << "size";
+    for (auto& pass : passes)
+        std::cout << std::setw(12) << pass.name;
+    std::cout << "   (ms)\n" << std::fixed << std::setprecision(3);
+    for (auto& result : results) {
+        std::cout << std::setw(10) << result.size;
+        for (auto& pass : result.passes)
+            std::cout << std::setw(12) << pass.wall * 1.0e3;
+        std::cout << "\n";
+    }
+    std::cout << std::setw(10) << "scaling";
+    for (size_t i = 0; i < passes.size(); ++i) {
+        auto k = scaling(results.front(), results.back(), i);
+        std::ostringstream os;
+        if (std::isnan(k))
+            os << "-  ";
+        else
+            os << std::fixed << std::setprecision(2) << k << (k > max_scaling ? " !" : "  ");
+        std::cout << std::setw(12) << os.str();
+    }
+    std::cout << "\n\n";
+}
+
+static void print_json(const Kind& kind, const std::vector<Result>& results, bool first) {
+    auto& passes = results.front().passes;
+    std::cout << (first ? "" : ",\n") << "  {\n    \"kind\": \"" << kind.name << "\",\n    \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::cout << (i > 0 ? ",\n" : "\n") << "      { \"size\": " << results[i].size;
+        for (auto& pass : results[i].passes)
+            std::cout << ", \"" << pass.name << "_ms\": " << pass.wall * 1.0e3;
+        std::cout << " }";
+    }
+    std::cout << "\n    ],\n    \"scaling\": {";
+    for (size_t i = 0; i < passes.size(); ++i) {
+        auto k = scaling(results.front(), results.back(), i);
+        std::cout << (i > 0 ? ", " : " ") << "\"" << passes[i].name << "\": ";
+        if (std::isnan(k))
+            std::cout << "null";
+        else
+            std::cout << k;
+    }
+    std::cout << " }\n  }";
+}
+
+int main(int argc, char** argv) {
+    std::vector<const Kind*> selected;
+    size_t iterations = 5;
+    size_t steps = 4;
+    double factor = 1;
+    bool json = false;
+    bool strict = false;
+    auto find_kind = [] (const char* name) -> const Kind* {
+        for (auto& kind : kinds) {
+            if (!strcmp(kind.name, name))
+                return &kind;
+        }
+        log::error("unknown kind of program '{}'", name);
+        return nullptr;
+    };
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            steps = std::strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc)
+            factor = std::strtod(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "-p") && i + 2 < argc) {
+            auto kind = find_kind(argv[i + 1]);
+            if (!kind)
+                return EXIT_FAILURE;
+            std::cout << kind->generate(std::max(std::strtoull(argv[i + 2], nullptr, 10), 2ull));
+            return EXIT_SUCCESS;
+        } else if (!strcmp(argv[i], "--json"))
+            json = true;
+        else if (!strcmp(argv[i], "--strict"))
+            strict = true;
+        else if (argv[i][0] == '-') {
+            usage();
+            return EXIT_FAILURE;
+        } else if (auto kind = find_kind(argv[i]))
+            selected.push_back(kind);
+        else
+            return EXIT_FAILURE;
+    }
+    if (iterations == 0 || steps == 0 || factor <= 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+    if (selected.empty()) {
+        for (auto& kind : kinds)
+            selected.push_back(&kind);
+    }
+
+    if (json)
+        std::cout << "[\n";
+    bool success = true;
+    for (size_t i = 0; i < selected.size(); ++i) {
+        auto& kind = *selected[i];
+        std::vector<Result> results;
+        auto size = std::max(size_t(double(kind.size) * factor), size_t(2));
+        for (size_t j = 0; j < steps; ++j, size *= 2) {
+            Result result { size, {} };
+            if (!measure(kind.generate(size), iterations, result)) {
+                log::error("the generated program of kind '{}' and size {} does not compile", kind.name, size);
+                return EXIT_FAILURE;
+            }
+            results.push_back(std::move(result));
+        }
+        // Timings are noisy on shared machines, so passes that scale badly only fail the benchmark with --strict
+        for (size_t j = 0, n = results.front().passes.size(); j < n; ++j) {
+            auto k = scaling(results.front(), results.back(), j);
+            if (k > max_scaling) {
+                log::warn("pass '{}' scales like O(n^{}) on programs of kind '{}'",
+                    results.front().passes[j].name, std::round(k * 100) / 100, kind.name);
+                success &= !strict;
+            }
+        }
+        if (json)
+            print_json(kind, results, i == 0);
+        else
+            print_text(kind, results);
+    }
+    if (json)
+        std::cout << "\n]\n";
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
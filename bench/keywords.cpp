@@ -0,0 +1,89 @@
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#include "artic/lexer.h"
+#include "artic/log.h"
+
+using namespace artic;
+
+static void usage() {
+    std::cout << "usage: bench_keywords [-n <iterations>] files...\n"
+                 "Measures the cost of looking up every identifier of the given files in the\n"
+                 "keyword table, compared to a lookup in an std::unordered_map.\n";
+}
+
+static void split_words(const std::string& data, std::vector<std::string>& words) {
+    for (size_t i = 0, n = data.size(); i < n;) {
+        if (std::isalpha(uint8_t(data[i])) || data[i] == '_') {
+            size_t j = i;
+            while (j < n && (std::isalnum(uint8_t(data[j])) || data[j] == '_')) j++;
+            words.emplace_back(data, i, j - i);
+            i = j;
+        } else
+            i++;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    size_t iterations = 100;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if (argv[i][0] == '-') {
+            usage();
+            return EXIT_FAILURE;
+        } else
+            files.push_back(argv[i]);
+    }
+    if (files.empty() || iterations == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> words;
+    for (auto& file : files) {
+        std::ifstream is(file);
+        if (!is) {
+            log::error("cannot open file '{}'", file);
+            return EXIT_FAILURE;
+        }
+        std::ostringstream os;
+        os << is.rdbuf();
+        split_words(os.str(), words);
+    }
+
+    // Reference implementation: the keyword map used by previous versions of the lexer
+    std::unordered_map<std::string, Token::Tag> map;
+#define TAG(t, str) if (std::isalpha(str[0])) map.emplace(str, Token::t);
+    TOKEN_TAGS(TAG)
+#undef TAG
+
+    using Clock = std::chrono::steady_clock;
+    auto run = [&] (const char* name, auto&& find) {
+        size_t found = 0;
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            for (auto& word : words)
+                found += find(word);
+        }
+        auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        auto ns = seconds * 1.0e9 / (double(words.size()) * iterations);
+        std::cout << name << ": " << found / iterations << " keyword(s), " << ns << " ns/lookup\n";
+        return ns;
+    };
+
+    std::cout << words.size() << " identifier(s), " << iterations << " iteration(s)\n";
+    auto map_ns  = run("unordered_map", [&] (const std::string& word) { return map.count(word); });
+    auto hash_ns = run("perfect hash",  [&] (const std::string& word) { return size_t(Lexer::find_keyword(word).has_value()); });
+    std::cout << "speedup: " << map_ns / hash_ns << "x\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include "artic/lexer.h"
+#include "artic/log.h"
+
+using namespace artic;
+
+static void usage() {
+    std::cout << "usage: bench_lexer [-n <iterations>] files...\n"
+                 "Measures the throughput of the lexer on the given files, when reading\n"
+                 "from a stream and when reading directly from memory.\n";
+}
+
+template <typename Input>
+static size_t lex(Log& log, uint32_t file, Input&& input) {
+    Lexer lexer(log, file, input);
+    size_t count = 0;
+    while (lexer.next().tag() != Token::End)
+        count++;
+    return count;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    size_t iterations = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if (argv[i][0] == '-') {
+            usage();
+            return EXIT_FAILURE;
+        } else
+            files.push_back(argv[i]);
+    }
+    if (files.empty() || iterations == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    size_t bytes = 0;
+    std::vector<std::string> data;
+    for (auto& file : files) {
+        std::ifstream is(file);
+        if (!is) {
+            log::error("cannot open file '{}'", file);
+            return EXIT_FAILURE;
+        }
+        std::ostringstream os;
+        os << is.rdbuf();
+        data.push_back(os.str());
+        bytes += data.back().size();
+    }
+
+    // Diagnostics are not part of the measurement
+    std::ostream null_stream(nullptr);
+    log::Output null_out(null_stream, false);
+    Log log(null_out);
+
+    using Clock = std::chrono::steady_clock;
+    auto run = [&] (const char* name, bool from_memory) {
+        size_t tokens = 0;
+        Clock::duration total {};
+        for (size_t i = 0; i < iterations; ++i) {
+            for (size_t j = 0, n = files.size(); j < n; ++j) {
+                std::istringstream is(data[j]);
+                auto start = Clock::now();
+                tokens += from_memory
+                    ? lex(log, uint32_t(j), std::string_view(data[j]))
+                    : lex(log, uint32_t(j), is);
+                total += Clock::now() - start;
+            }
+        }
+        auto seconds = std::chrono::duration<double>(total).count();
+        auto mbs = double(bytes) * iterations / (seconds * 1.0e6);
+        std::cout << name << ": " << tokens / iterations << " tokens, " << mbs << " MB/s\n";
+        return mbs;
+    };
+
+    std::cout << files.size() << " file(s), " << bytes << " bytes, " << iterations << " iteration(s)\n";
+    auto stream_mbs = run("stream", false);
+    auto memory_mbs = run("memory", true);
+    std::cout << "speedup: " << memory_mbs / stream_mbs << "x\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/resource.h>
+
+#include "artic/parser.h"
+#include "artic/bind.h"
+#include "artic/check.h"
+#include "artic/log.h"
+
+using namespace artic;
+
+static void usage() {
+    std::cout << "usage: bench_types [-n <iterations>] [-g <functions>] files...\n"
+                 "Measures the time taken to type check the given files, along with the number\n"
+                 "of types created and the memory used by the type table. With -g, a program\n"
+                 "with the given number of functions over nested generic types is checked as well.\n";
+}
+
+// Builds the type `P[P[..., ...], P[..., ...]]`, nested `depth` times
+static std::string nested_type(size_t depth, const std::string& a, const std::string& b) {
+    if (depth == 0)
+        return "P[" + a + ", " + b + "]";
+    return "P[" + nested_type(depth - 1, a, b) + ", " + nested_type(depth - 1, b, a) + "]";
+}
+
+static std::string generate(size_t functions) {
+    static const char* prims[] = { "i32", "i64", "f32", "bool", "u8", "(i32, f64)" };
+    static constexpr size_t prim_count = sizeof(prims) / sizeof(prims[0]);
+    std::ostringstream os;
+    os << "struct P[A, B] { a: A, b: B, c: (A, B), d: fn (A) -> B }\n"
+          "fn @first[A, B](p: P[A, B]) -> A = p.a;\n"
+          "fn @second[A, B](p: P[A, B]) -> B = p.b;\n"
+          "fn @swap[A, B](p: P[A, B]) -> P[B, A] = P[B, A] { a = p.b, b = p.a, c = (p.b, p.a), d = @|_x: B| -> A p.a };\n";
+    for (size_t i = 0; i < functions; ++i) {
+        auto type = nested_type(2 + i % 3, prims[i % prim_count], prims[(i / prim_count) % prim_count]);
+        os << "fn f" << i << "(p: " << type << ") {\n"
+              "    let _q = swap(p);\n"
+              "    let _a = first(swap(p)).a.b;\n"
+              "    let _c = swap(swap(p.a)).c;\n"
+              "    let _d = second(p).a.d;\n"
+              "}\n";
+    }
+    return os.str();
+}
+
+struct Result {
+    double seconds = 0;
+    size_t types = 0;
+    size_t memory = 0;
+};
+
+static bool check(const std::vector<std::string>& data, Result& result) {
+    // Diagnostics are not part of the measurement
+    std::ostream null_stream(nullptr);
+    log::Output null_out(null_stream, false);
+    Log log(null_out);
+    ast::ModDecl program;
+    program.arena = std::make_unique<Arena>();
+    Arena::Scope arena_scope(*program.arena);
+    for (size_t i = 0, n = data.size(); i < n; ++i) {
+        Lexer lexer(log, uint32_t(i), std::string_view(data[i]));
+        Parser parser(log, lexer);
+        auto module = parser.parse();
+        program.decls.insert(
+            program.decls.end(),
+            std::make_move_iterator(module->decls.begin()),
+            std::make_move_iterator(module->decls.end())
+        );
+    }
+    if (log.errors > 0)
+        return false;
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    TypeTable type_table;
+    NameBinder name_binder(log);
+    TypeChecker type_checker(log, type_table);
+    if (!name_binder.run(program) || !type_checker.run(program))
+        return false;
+    result.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    result.types  = type_table.type_count();
+    result.memory = type_table.memory_usage();
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    size_t iterations = 10;
+    size_t functions = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "-g") && i + 1 < argc)
+            functions = std::strtoull(argv[++i], nullptr, 10);
+        else if (argv[i][0] == '-') {
+            usage();
+            return EXIT_FAILURE;
+        } else
+            files.push_back(argv[i]);
+    }
+    if ((files.empty() && functions == 0) || iterations == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> data;
+    for (auto& file : files) {
+        std::ifstream is(file);
+        if (!is) {
+            log::error("cannot open file '{}'", file);
+            return EXIT_FAILURE;
+        }
+        std::ostringstream os;
+        os << is.rdbuf();
+        data.push_back(os.str());
+    }
+    if (functions > 0)
+        data.push_back(generate(functions));
+
+    Result result;
+    for (size_t i = 0; i < iterations; ++i) {
+        if (!check(data, result)) {
+            log::error("the input contains errors");
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << data.size() << " file(s), " << iterations << " iteration(s)\n"
+              << "check: " << result.seconds * 1.0e3 / iterations << " ms\n"
+              << "types: " << result.types << "\n"
+              << "type table memory: " << result.memory / 1024 << " KB\n"
+              << "peak memory: " << usage.ru_maxrss << " KB\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,18 @@
+# Writes a header defining `ARTIC_BUILD_ID`, which is made of the version of the compiler and of a hash
+# of its sources. The sources are separated by '|' in `SOURCES`, since lists cannot be passed to scripts.
+# The header is only written when its contents change, so that it does not trigger useless rebuilds.
+string(REPLACE "|" ";" SOURCES "${SOURCES}")
+set(hashes "")
+foreach (source ${SOURCES})
+    file(SHA1 ${source} hash)
+    set(hashes "${hashes}${hash}")
+endforeach ()
+string(SHA1 hash "${hashes}")
+set(header "#define ARTIC_BUILD_ID \"${VERSION}-${hash}\"\n")
+set(old_header "")
+if (EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} old_header)
+endif ()
+if (NOT header STREQUAL old_header)
+    file(WRITE ${OUTPUT} "${header}")
+endif ()
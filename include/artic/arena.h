@@ -0,0 +1,123 @@
+#ifndef ARTIC_ARENA_H
+#define ARTIC_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <typeinfo>
+#include <typeindex>
+#include <unordered_map>
+
+namespace artic {
+
+/// Bump allocator: Objects are allocated in large blocks, which are released all at once
+/// when the arena is destroyed. The arena never calls the destructors of the objects it contains.
+class Arena {
+public:
+    static constexpr size_t default_block_size() { return 64 * 1024; }
+
+    Arena(size_t block_size = default_block_size())
+        : block_size_(block_size)
+    {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator = (const Arena&) = delete;
+
+    /// Allocates memory for an object of the given size and alignment.
+    void* alloc(size_t size, size_t align) {
+        auto ptr = align_up(cur_, align);
+        if (!ptr || size > size_t(end_ - ptr))
+            return alloc_block(size, align);
+        cur_ = ptr + size;
+        return ptr;
+    }
+
+    /// Takes ownership of the memory of another arena, which becomes empty.
+    void merge(Arena& other) {
+        blocks_.insert(blocks_.end(),
+            std::make_move_iterator(other.blocks_.begin()),
+            std::make_move_iterator(other.blocks_.end()));
+        capacity_ += other.capacity_;
+        other.blocks_.clear();
+        other.cur_ = other.end_ = nullptr;
+        other.capacity_ = 0;
+        if (counts_ && other.counts_) {
+            for (auto& pair : *other.counts_)
+                (*counts_)[pair.first] += pair.second;
+        }
+        other.counts_.reset();
+    }
+
+    /// Returns the amount of memory reserved by this arena, in bytes.
+    size_t capacity() const { return capacity_; }
+
+    /// Number of objects of each type created in an arena.
+    using Counts = std::unordered_map<std::type_index, size_t>;
+
+    /// Starts counting the objects created in this arena by type (see `count()`).
+    void enable_counts() { if (!counts_) counts_ = std::make_unique<Counts>(); }
+    /// Returns the number of objects of each type created so far, or null if counting is disabled.
+    const Counts* counts() const { return counts_.get(); }
+
+    /// Records the creation of an object of the given type, if counting is enabled.
+    template <typename T>
+    void count() {
+        if (counts_)
+            (*counts_)[typeid(T)]++;
+    }
+
+    /// Returns the arena in which AST nodes are allocated on the current thread, if any.
+    static Arena* current() { return current_; }
+
+    /// Makes an arena the current one on this thread, until the object is destroyed.
+    class Scope {
+    public:
+        Scope(Arena& arena)
+            : old_(current_)
+        {
+            current_ = &arena;
+        }
+        ~Scope() { current_ = old_; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator = (const Scope&) = delete;
+
+    private:
+        Arena* old_;
+    };
+
+private:
+    static char* align_up(char* ptr, size_t align) {
+        auto addr = reinterpret_cast<uintptr_t>(ptr);
+        return reinterpret_cast<char*>((addr + align - 1) & ~uintptr_t(align - 1));
+    }
+
+    void* alloc_block(size_t size, size_t align) {
+        // Large objects get a block of their own, so as to not waste the rest of the current block
+        auto block_size = size + align > block_size_ / 4 ? size + align : block_size_;
+        blocks_.emplace_back(new char[block_size]);
+        capacity_ += block_size;
+        auto first = blocks_.back().get();
+        auto ptr = align_up(first, align);
+        if (block_size == block_size_) {
+            cur_ = ptr + size;
+            end_ = first + block_size;
+        }
+        return ptr;
+    }
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    size_t block_size_;
+    size_t capacity_ = 0;
+    std::unique_ptr<Counts> counts_;
+
+    static inline thread_local Arena* current_ = nullptr;
+};
+
+} // namespace artic
+
+#endif // ARTIC_ARENA_H
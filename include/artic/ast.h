@@ -2,6 +2,7 @@
 #define ARTIC_AST_H
 
 #include <memory>
+#include <new>
 #include <vector>
 #include <variant>
 
@@ -10,6 +11,7 @@
 #include "artic/cast.h"
 #include "artic/token.h"
 #include "artic/symbol.h"
+#include "artic/arena.h"
 
 namespace thorin {
     class Def;
@@ -23,12 +25,33 @@ struct Printer;
 class NameBinder;
 class TypeChecker;
 class Emitter;
+class Serializer;
+
+/// Deleter for AST nodes, which are either allocated on the heap, or in an arena.
+/// The memory of nodes that live in an arena is released with the arena itself.
+struct PtrDeleter {
+    template <typename T>
+    void operator () (T* ptr) const {
+        if (ptr->in_arena)
+            ptr->~T();
+        else
+            delete ptr;
+    }
+};
 
-template <typename T> using Ptr = std::unique_ptr<T>;
-template <typename T> using PtrVector = std::vector<std::unique_ptr<T>>;
+template <typename T> using Ptr = std::unique_ptr<T, PtrDeleter>;
+template <typename T> using PtrVector = std::vector<Ptr<T>>;
+
+/// Creates an AST node in the current arena, or on the heap if there is none.
 template <typename T, typename... Args>
-std::unique_ptr<T> make_ptr(Args&&... args) {
-    return std::make_unique<T>(std::forward<Args>(args)...);
+Ptr<T> make_ptr(Args&&... args) {
+    if (auto arena = Arena::current()) {
+        auto ptr = new (arena->alloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        ptr->in_arena = true;
+        arena->count<T>();
+        return Ptr<T>(ptr);
+    }
+    return Ptr<T>(new T(std::forward<Args>(args)...));
 }
 
 namespace ast {
@@ -36,11 +59,11 @@ namespace ast {
 /// Identifier with its location in the file
 struct Identifier {
     Loc loc;
-    std::string name;
+    Name name;
 
     Identifier() {}
-    Identifier(const Loc& loc, std::string&& name)
-        : loc(loc), name(std::move(name))
+    Identifier(const Loc& loc, Name name)
+        : loc(loc), name(name)
     {}
 };
 
@@ -48,6 +71,8 @@ struct Identifier {
 struct Node : public Cast<Node> {
     /// Location of the node in the source file.
     Loc loc;
+    /// True if the node has been allocated in an arena by `make_ptr()`.
+    bool in_arena = false;
 
     /// Type assigned after type inference. Not all nodes are typeable.
     mutable const artic::Type* type = nullptr;
@@ -61,7 +86,13 @@ struct Node : public Cast<Node> {
         : loc(loc)
     {}
 
-    Node(Node&&) = default;
+    // The node is moved to a new location, which is not in an arena
+    Node(Node&& node)
+        : loc(node.loc)
+        , type(node.type)
+        , def(node.def)
+        , attrs(std::move(node.attrs))
+    {}
 
     virtual ~Node() {}
 
@@ -75,6 +106,8 @@ struct Node : public Cast<Node> {
     virtual const thorin::Def* emit(Emitter&) const;
     /// Prints the node with the given formatting parameters.
     virtual void print(Printer&) const = 0;
+    /// Writes the node in binary form (see `Serializer`).
+    virtual void serialize(Serializer&) const = 0;
 
     /// Prints the node on the console, for debugging.
     void dump() const;
@@ -90,6 +123,10 @@ struct Decl : public Node {
 
     /// Set to true if this declaration is at the top level of a module.
     bool is_top_level = false;
+    /// Set to false if this declaration cannot be reached from the exported functions or the
+    /// mutable static variables of the program, in which case it is neither type-checked nor
+    /// emitted (see `NameBinder::mark_reachable()`).
+    bool is_reachable = true;
 
     /// Binds the declaration to its AST node, without entering sub-AST nodes.
     virtual void bind_head(NameBinder&) {}
@@ -174,7 +211,7 @@ struct Path : public Node {
     };
 
     std::vector<Elem> elems;
-    std::shared_ptr<Symbol> symbol;
+    Symbol* symbol = nullptr;
 
     // Set during type-checking
     bool is_value = false;
@@ -189,6 +226,7 @@ struct Path : public Node {
     const thorin::Def* emit(Emitter&) const override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Filter --------------------------------------------------------------------------
@@ -205,22 +243,23 @@ struct Filter : public Node {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Attributes ----------------------------------------------------------------------
 
 /// Base class for all attributes.
 struct Attr : public Node {
-    std::string name;
+    Name name;
 
-    Attr(const Loc& loc, std::string&& name)
-        : Node(loc), name(std::move(name))
+    Attr(const Loc& loc, Name name)
+        : Node(loc), name(name)
     {}
 
     /// Checks that the attribute is well-formed.
     virtual void check(TypeChecker&, const ast::Node*) = 0;
     /// Finds the sub-attribute with the given name in this attribute.
-    virtual const Attr* find(const std::string_view&) const;
+    virtual const Attr* find(Name) const;
 
     void bind(NameBinder&) override;
 };
@@ -229,25 +268,27 @@ struct Attr : public Node {
 struct PathAttr : public Attr {
     Path path;
 
-    PathAttr(const Loc& loc, std::string&& name, Path&& path)
-        : Attr(loc, std::move(name)), path(std::move(path))
+    PathAttr(const Loc& loc, Name name, Path&& path)
+        : Attr(loc, name), path(std::move(path))
     {}
 
     void check(TypeChecker&, const ast::Node*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Attribute with an associated literal.
 struct LiteralAttr : public Attr {
     Literal lit;
 
-    LiteralAttr(const Loc& loc, std::string&& name, const Literal& lit)
-        : Attr(loc, std::move(name)), lit(lit)
+    LiteralAttr(const Loc& loc, Name name, const Literal& lit)
+        : Attr(loc, name), lit(lit)
     {}
 
     void check(TypeChecker&, const ast::Node*) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Attribute with only a name, optionally followed by a list of attribute
@@ -255,25 +296,27 @@ struct LiteralAttr : public Attr {
 struct NamedAttr : public Attr {
     PtrVector<Attr> args;
 
-    NamedAttr(const Loc& loc, std::string&& name, PtrVector<Attr>&& args)
-        : Attr(loc, std::move(name)), args(std::move(args))
+    NamedAttr(const Loc& loc, Name name, PtrVector<Attr>&& args)
+        : Attr(loc, name), args(std::move(args))
     {}
 
-    const Attr* find(const std::string_view&) const override;
+    const Attr* find(Name) const override;
 
     void check(TypeChecker&, const ast::Node*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Attribute list for statement blocks, or function declarations.
 struct AttrList : public NamedAttr {
     AttrList(const Loc& loc, PtrVector<Attr>&& attrs)
-        : NamedAttr(loc, "", std::move(attrs))
+        : NamedAttr(loc, Name(), std::move(attrs))
     {}
 
     void check(TypeChecker&, const ast::Node*) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Types ---------------------------------------------------------------------------
@@ -305,9 +348,10 @@ struct PrimType : public Type {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 
     static std::string tag_to_string(Tag tag);
-    static Tag tag_from_token(const Token&);
+    static Tag tag_from_name(Name);
 };
 
 /// Tuple type, made of a product of simpler types.
@@ -321,6 +365,7 @@ struct TupleType : public Type {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Base class for array types.
@@ -345,6 +390,7 @@ struct SizedArrayType : public ArrayType {
 
     const artic::Type* infer(TypeChecker&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Unsized array type.
@@ -355,6 +401,7 @@ struct UnsizedArrayType : public ArrayType {
 
     const artic::Type* infer(TypeChecker&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Function type, consisting of domain and codomain types.
@@ -369,6 +416,7 @@ struct FnType : public Type {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 struct PtrType : public Type {
@@ -383,6 +431,7 @@ struct PtrType : public Type {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A type application.
@@ -396,6 +445,7 @@ struct TypeApp : public Type {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Type resulting from a parsing error.
@@ -406,6 +456,7 @@ struct ErrorType : public Type {
 
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Statements ----------------------------------------------------------------------
@@ -427,6 +478,7 @@ struct DeclStmt : public Stmt {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Statement containing a declaration.
@@ -446,6 +498,7 @@ struct ExprStmt : public Stmt {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Expressions ---------------------------------------------------------------------
@@ -469,6 +522,7 @@ struct TypedExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Expression made of a path to an identifier.
@@ -486,6 +540,7 @@ struct PathExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Expression made of a literal.
@@ -503,6 +558,7 @@ struct LiteralExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Field expression, part of a record expression.
@@ -531,6 +587,7 @@ struct FieldExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Record-like braced expression containing fields
@@ -571,6 +628,7 @@ struct RecordExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Expression enclosed by parenthesis and made of several expressions separated by commas.
@@ -590,6 +648,7 @@ struct TupleExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Array expression.
@@ -610,6 +669,7 @@ struct ArrayExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Array expression repeating a given value a given number of times.
@@ -631,6 +691,7 @@ struct RepeatArrayExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Anonymous function expression.
@@ -661,6 +722,7 @@ struct FnExpr : public Expr {
     void bind(NameBinder&, bool);
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Block of code, whose result is the last expression in the block.
@@ -680,6 +742,7 @@ struct BlockExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Function or constructor call with a single expression (can be a tuple) for the arguments.
@@ -702,6 +765,7 @@ struct CallExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Projection operator (.).
@@ -734,6 +798,7 @@ struct ProjExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// If/Else expression (the else branch is optional).
@@ -778,6 +843,7 @@ struct IfExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Case within a match expression.
@@ -796,6 +862,7 @@ struct CaseExpr : public Expr {
 
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Match expression.
@@ -817,6 +884,7 @@ struct MatchExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Base class for loop expressions (while, for)
@@ -854,6 +922,7 @@ struct WhileExpr : public LoopExpr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// For loop expression.
@@ -871,6 +940,7 @@ struct ForExpr : public LoopExpr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Break expression.
@@ -885,6 +955,7 @@ struct BreakExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Break expression.
@@ -899,6 +970,7 @@ struct ContinueExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Break expression.
@@ -913,6 +985,7 @@ struct ReturnExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Unary expression (negation, increment, ...).
@@ -951,6 +1024,7 @@ struct UnaryExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 
     bool is_inc() const { return is_inc(tag); }
     bool is_dec() const { return is_dec(tag); }
@@ -1003,6 +1077,7 @@ struct BinaryExpr : public Expr {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 
     static Tag remove_eq(Tag);
     static bool has_eq(Tag);
@@ -1036,6 +1111,7 @@ struct FilterExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Explicit cast using the `as` operator.
@@ -1058,6 +1134,7 @@ struct CastExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Implicit cast expression, inserted during type-checking.
@@ -1080,6 +1157,7 @@ struct ImplicitCastExpr : public Expr {
     const thorin::Def* emit(Emitter&) const override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Inline assembly expression.
@@ -1119,6 +1197,7 @@ struct AsmExpr : public Expr {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Incorrect expression, as a result of parsing.
@@ -1129,6 +1208,7 @@ struct ErrorExpr : public Expr {
 
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Declarations --------------------------------------------------------------------
@@ -1137,8 +1217,11 @@ struct ErrorExpr : public Expr {
 struct NamedDecl : public Decl {
     Identifier id;
 
+    // Set during name binding
+    Symbol symbol;
+
     NamedDecl(const Loc& loc, Identifier&& id)
-        : Decl(loc), id(std::move(id))
+        : Decl(loc), id(std::move(id)), symbol(this)
     {}
 };
 
@@ -1165,6 +1248,7 @@ struct TypeParam : public NamedDecl {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Type parameter list, of the form [T, U, ...]
@@ -1177,6 +1261,7 @@ struct TypeParamList : public Node {
 
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Pattern binding associated with an identifier.
@@ -1193,6 +1278,7 @@ struct PtrnDecl : public ValueDecl {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Declaration that introduces a new symbol in the scope, with an optional initializer.
@@ -1210,6 +1296,7 @@ struct LetDecl : public Decl {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Static (top-level) declaration.
@@ -1235,6 +1322,7 @@ struct StaticDecl : public ValueDecl {
     void bind_head(NameBinder&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Function declaration.
@@ -1258,6 +1346,7 @@ struct FnDecl : public ValueDecl {
     void bind_head(NameBinder&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Structure field declaration.
@@ -1278,6 +1367,7 @@ struct FieldDecl : public NamedDecl {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Base class for declarations holding fields.
@@ -1314,6 +1404,7 @@ struct StructDecl : public RecordDecl {
     void bind_head(NameBinder&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 struct EnumDecl;
@@ -1344,6 +1435,7 @@ struct OptionDecl : public RecordDecl {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Enumeration declaration.
@@ -1366,6 +1458,7 @@ struct EnumDecl : public CtorDecl {
     void bind_head(NameBinder&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Type alias declaration.
@@ -1388,10 +1481,14 @@ struct TypeDecl : public NamedDecl {
     void bind_head(NameBinder&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Module definition.
 struct ModDecl : public NamedDecl {
+    /// Arena holding the nodes of the program, only used for the top-level module.
+    /// It is declared first, so that it is destroyed after the nodes it contains.
+    std::unique_ptr<Arena> arena;
     PtrVector<Decl> decls;
 
     std::vector<const NamedDecl*> members;
@@ -1409,6 +1506,7 @@ struct ModDecl : public NamedDecl {
     void bind_head(NameBinder&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// Incorrect declaration, coming from parsing.
@@ -1417,6 +1515,7 @@ struct ErrorDecl : public Decl {
 
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 // Patterns ------------------------------------------------------------------------
@@ -1437,6 +1536,7 @@ struct TypedPtrn : public Ptrn {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// An identifier used as a pattern.
@@ -1456,6 +1556,7 @@ struct IdPtrn : public Ptrn {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A literal used as a pattern.
@@ -1472,6 +1573,7 @@ struct LiteralPtrn : public Ptrn {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A pattern that matches against a structure field.
@@ -1494,6 +1596,7 @@ struct FieldPtrn : public Ptrn {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A pattern that matches against record-like types with named fields.
@@ -1517,6 +1620,7 @@ struct RecordPtrn : public Ptrn {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A pattern that matches against constructor invocations.
@@ -1538,6 +1642,7 @@ struct CtorPtrn : public Ptrn {
     const artic::Type* infer(TypeChecker&) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A pattern that matches against tuples.
@@ -1556,6 +1661,7 @@ struct TuplePtrn : public Ptrn {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A pattern that matches arrays of fixed size.
@@ -1575,6 +1681,7 @@ struct ArrayPtrn : public Ptrn {
     const artic::Type* check(TypeChecker&, const artic::Type*) override;
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 /// A pattern resulting from a parsing error.
@@ -1585,6 +1692,7 @@ struct ErrorPtrn : public Ptrn {
 
     void bind(NameBinder&) override;
     void print(Printer&) const override;
+    void serialize(Serializer&) const override;
 };
 
 } // namespace ast
@@ -16,7 +16,7 @@ namespace artic {
 class NameBinder : public Logger {
 public:
     NameBinder(Log& log)
-        : Logger(log), cur_fn_(nullptr), cur_loop_(nullptr)
+        : Logger(log), cur_fn_(nullptr), cur_loop_(nullptr), cur_decl_(nullptr)
     {
         push_scope(true);
     }
@@ -28,10 +28,27 @@ public:
     bool run(ast::ModDecl&);
 
     bool warn_on_shadowing = false;
+    /// Records the top-level declarations that each top-level declaration refers to,
+    /// which is required by `mark_reachable()`.
+    bool track_uses = false;
 
     void bind_head(ast::Decl&);
     void bind(ast::Node&);
 
+    /// Marks the declarations of a program that has been bound with `track_uses` set, and that cannot
+    /// be reached from its exported functions or its mutable static variables, as unreachable.
+    void mark_reachable(ast::ModDecl&);
+
+    ast::Decl* cur_decl() const { return cur_decl_; }
+    ast::Decl* push_decl(ast::Decl* decl) {
+        auto old = cur_decl_;
+        cur_decl_ = decl;
+        return old;
+    }
+    void pop_decl(ast::Decl* decl) { cur_decl_ = decl; }
+    /// Records that the current top-level declaration uses the given path, if uses are tracked.
+    void use(const ast::Path&);
+
     ast::FnExpr* cur_fn() const { return cur_fn_; }
     ast::FnExpr* push_fn(ast::FnExpr* fn) {
         auto old = cur_fn_;
@@ -48,47 +65,28 @@ public:
     }
     void pop_loop(ast::LoopExpr* loop) { cur_loop_ = loop; }
 
-    void push_scope(bool top_level = false) { scopes_.emplace_back(top_level); }
+    /// Pushes a new scope. The symbols of enclosing scopes are not visible from an isolated scope.
+    void push_scope(bool top_level = false, bool isolated = false) { symbols_.push_scope(top_level, isolated); }
     void pop_scope();
     void insert_symbol(ast::NamedDecl&);
 
-    std::shared_ptr<Symbol> find_symbol(const std::string& name) {
-        for (auto it = scopes_.rbegin(); it != scopes_.rend(); it++) {
-            if (auto decl = it->find(name)) return decl;
-        }
-        return nullptr;
-    }
-    std::shared_ptr<Symbol> find_similar_symbol(const std::string& name) {
-        auto min = levenshtein_threshold();
-        std::shared_ptr<Symbol> best;
-        for (auto it = scopes_.rbegin(); it != scopes_.rend(); it++) {
-            auto pair = it->find_similar(name, min, levenshtein);
-            if (pair.second) {
-                min  = pair.first;
-                best = pair.second;
-            }
-        }
-        return best;
+    Symbol* find_symbol(Name name) const { return symbols_.find(name); }
+    Symbol* find_similar_symbol(Name name) {
+        return symbols_.find_similar(name, levenshtein_threshold(), levenshtein);
     }
 
 private:
     // Levenshtein distance is used to suggest similar identifiers to the user
     static constexpr size_t levenshtein_threshold() { return 3; }
-    static size_t levenshtein(const std::string_view& a, const std::string_view& b, size_t max) {
-        if (max == 0 || a.empty() || b.empty())
-            return std::max(a.size(), b.size());
-        auto d = a.front() != b.front() ? 1 : 0;
-        auto d1 = levenshtein(a.substr(1), b, max - 1) + 1;
-        auto d2 = levenshtein(a, b.substr(1), max - 1) + 1;
-        auto d3 = levenshtein(a.substr(1), b.substr(1), max - d) + d;
-        return std::min(d1, std::min(d2, d3));
-    }
+    // Returns the distance between `a` and `b`, or any value greater than `max` if it exceeds `max`
+    static size_t levenshtein(const std::string_view& a, const std::string_view& b, size_t max);
 
     ast::FnExpr*   cur_fn_;
     ast::LoopExpr* cur_loop_;
-    std::vector<SymbolTable> scopes_;
+    ast::Decl*     cur_decl_;
+    SymbolTable symbols_;
 
-    friend struct ast::ModDecl;
+    std::unordered_map<const ast::Decl*, std::vector<const ast::Path*>> uses_;
 };
 
 } // namespace artic
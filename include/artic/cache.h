@@ -0,0 +1,41 @@
+#ifndef ARTIC_CACHE_H
+#define ARTIC_CACHE_H
+
+#include <string>
+#include <string_view>
+
+#include "artic/ast.h"
+
+namespace artic {
+
+/// On-disk cache holding the AST of parsed files in binary form (see `serialize()`).
+/// Entries are identified by a hash of the contents of the file they come from, so
+/// that files that do not change between compilations are not parsed every time.
+class Cache {
+public:
+    explicit Cache(std::string dir)
+        : dir_(std::move(dir))
+    {}
+
+    /// Returns the default cache directory, `$XDG_CACHE_HOME/artic` or `$HOME/.cache/artic`,
+    /// or an empty string if none of these variables is set.
+    static std::string default_dir();
+
+    /// Loads the AST of a file with the given contents, with its nodes allocated in the current arena
+    /// and its locations assigned to the given file. Returns null if the file is not in the cache.
+    Ptr<ast::ModDecl> load(std::string_view data, uint32_t file) const;
+    /// Stores the AST of a file with the given contents, if the file has already been parsed
+    /// with the same contents before. Since the cache is only used to speed up compilation,
+    /// this function fails silently if the cache cannot be written.
+    void store(std::string_view data, const ast::ModDecl&) const;
+
+private:
+    std::string entry(std::string_view data) const;
+    void write(const std::string& path, std::string_view contents) const;
+
+    std::string dir_;
+};
+
+} // namespace artic
+
+#endif // ARTIC_CACHE_H
@@ -2,6 +2,7 @@
 #define ARTIC_CHECK_H
 
 #include <unordered_set>
+#include <vector>
 #include <optional>
 
 #include "artic/ast.h"
@@ -22,7 +23,10 @@ public:
 
     /// Performs type checking on a whole program.
     /// Returns true on success, otherwise false.
-    bool run(ast::ModDecl&);
+    /// Declarations are inferred first, and then the bodies of the functions
+    /// that have an explicit return type are checked concurrently,
+    /// using at most the given number of threads (0 means the default).
+    bool run(ast::ModDecl&, size_t max_threads = 0);
 
     // Should be called to avoid infinite recursion
     // when inferring the type of recursive declarations
@@ -30,12 +34,16 @@ public:
     bool enter_decl(const ast::Decl*);
     void exit_decl(const ast::Decl*);
 
+    // Returns true when the body of the given function is checked
+    // after all the declarations of the program have been inferred.
+    bool defer_body(ast::FnDecl&);
+
     bool should_report_error(const Type*);
 
     const Type* incompatible_types(const Loc&, const Type*, const Type*);
     const Type* incompatible_type(const Loc&, const std::string_view&, const Type*);
     const Type* type_expected(const Loc&, const Type*, const std::string_view&);
-    const Type* unknown_member(const Loc&, const UserType*, const std::string_view&);
+    const Type* unknown_member(const Loc&, const UserType*, Name);
     const Type* cannot_infer(const Loc&, const std::string_view&);
     const Type* unreachable_code(const Loc&, const Loc&, const Loc&);
     const Type* mutable_expected(const Loc&);
@@ -44,7 +52,7 @@ public:
     const Type* invalid_simd(const Loc&, const Type*);
     void invalid_ptrn(const Loc&, bool);
     void invalid_constraint(const Loc&, const TypeVar*, const Type*, const Type*, const Type*);
-    void invalid_attr(const Loc&, const std::string_view&);
+    void invalid_attr(const Loc&, Name);
     void unsized_type(const Loc&, const Type*);
 
     const Type* expect(const Loc&, const Type*, const Type*);
@@ -81,7 +89,21 @@ public:
     const Type* infer_record_type(const TypeApp*, const StructType*, size_t&);
 
 private:
+    /// Function body whose checking has been deferred, along with the position in the
+    /// log where its diagnostics would have been reported if it had been checked right away.
+    struct DeferredBody {
+        ast::FnDecl* fn_decl;
+        size_t offset;
+        size_t errors;
+        size_t warns;
+    };
+
+    void collect_bodies(ast::ModDecl&);
+    void check_body(ast::FnDecl&);
+
     std::unordered_set<const ast::Decl*> decls_;
+    std::unordered_set<const ast::FnDecl*> deferred_;
+    std::vector<DeferredBody> bodies_;
 };
 
 } // namespace artic
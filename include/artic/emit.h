@@ -2,6 +2,7 @@
 #define ARTIC_EMIT_H
 
 #include <string>
+#include <string_view>
 #include <cassert>
 
 #include <thorin/util/location.h>
@@ -11,6 +12,7 @@
 #include "artic/types.h"
 #include "artic/log.h"
 #include "artic/hash.h"
+#include "artic/stats.h"
 
 namespace thorin {
     class World;
@@ -21,6 +23,7 @@ namespace thorin {
 namespace artic {
 
 struct StructType;
+class Cache;
 
 /// Helper class for Thorin IR generation.
 class Emitter : public Logger {
@@ -90,7 +93,7 @@ public:
     /// Map of all types to avoid converting the same type several times.
     std::unordered_map<const Type*, const thorin::Type*> types;
     /// Map from the currently bound type variables to monomorphic types.
-    std::unordered_map<const TypeVar*, const Type*> type_vars;
+    TypeVarMap<const Type*> type_vars;
     /// Map from monomorphic function signature to emitted thorin function.
     std::unordered_map<MonoFn, thorin::Continuation*, Hash, Compare> mono_fns;
     /// Map from enum type and variant index to variant constructor.
@@ -146,15 +149,27 @@ public:
 
 /// Helper function to compile a set of files and generate an AST and a thorin module.
 /// Errors are reported in the log, and this function returns true on success.
+/// The file data is not copied, and must outlive the log and its locator.
+/// Timings and counters are recorded in the given statistics, if any.
+/// When `reachable_only` is set, only the declarations that can be reached from the exported
+/// functions or the mutable static variables of the program are type-checked and emitted.
+/// When a cache is given, the files it contains are loaded from it instead of being parsed,
+/// and the files that are parsed without any diagnostic are added to it.
+/// When `round_trip_ast` is set, the AST of each file is serialized after parsing and
+/// replaced by the one read back from its binary form, which is used to test the serializer.
 bool compile(
     const std::vector<std::string>& file_names,
-    const std::vector<std::string>& file_data,
+    const std::vector<std::string_view>& file_data,
     bool warns_as_errors,
     bool enable_all_warns,
+    bool reachable_only,
     ast::ModDecl& program,
     thorin::World& world,
     thorin::Log::Level log_level,
-    Log& log);
+    Log& log,
+    Stats* stats = nullptr,
+    const Cache* cache = nullptr,
+    bool round_trip_ast = false);
 
 } // namespace artic
 
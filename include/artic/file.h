@@ -0,0 +1,41 @@
+#ifndef ARTIC_FILE_H
+#define ARTIC_FILE_H
+
+#include <string>
+#include <string_view>
+#include <optional>
+
+namespace artic {
+
+/// Reads the contents of a file, returning `std::nullopt` if it cannot be read.
+std::optional<std::string> read_file(const std::string& file, bool binary = false);
+
+/// Contents of a file. Regular files are memory-mapped, so that they can
+/// be read without copying them, and other files are read in memory.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    /// Opens the given file, and returns false if it cannot be opened or if it is a directory.
+    /// Binary files are never subject to line-ending conversions.
+    bool open(const std::string& file, bool binary = false);
+
+    std::string_view data() const {
+        return mapping_
+            ? std::string_view(static_cast<const char*>(mapping_), size_)
+            : std::string_view(buffer_);
+    }
+
+private:
+    void* mapping_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_;
+};
+
+} // namespace artic
+
+#endif // ARTIC_FILE_H
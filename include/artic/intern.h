@@ -0,0 +1,65 @@
+#ifndef ARTIC_INTERN_H
+#define ARTIC_INTERN_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <functional>
+
+namespace artic {
+
+/// Interned string, used for identifiers and attribute names.
+/// Names are stored in a global, thread-safe table, which is never cleared:
+/// Two names are equal if and only if they point to the same entry in that table,
+/// which makes comparing and hashing them a constant-time operation.
+class Name {
+public:
+    struct Entry {
+        std::string_view str;
+        size_t hash;    ///< Hash of the contents of the string
+        uint32_t id;    ///< Unique identifier, 0 for the empty string
+    };
+
+    /// Builds the empty name.
+    Name() : entry_(&empty_entry) {}
+    /// Interns the given string.
+    explicit Name(std::string_view);
+
+    std::string_view str() const { return entry_->str; }
+    size_t hash() const { return entry_->hash; }
+    uint32_t id() const { return entry_->id; }
+
+    bool empty() const { return entry_ == &empty_entry; }
+    size_t size() const { return entry_->str.size(); }
+    char operator [] (size_t i) const { return entry_->str[i]; }
+
+    bool operator == (const Name& other) const { return entry_ == other.entry_; }
+    bool operator != (const Name& other) const { return entry_ != other.entry_; }
+    bool operator == (std::string_view other) const { return entry_->str == other; }
+    bool operator != (std::string_view other) const { return entry_->str != other; }
+
+    /// Returns the number of names that have been interned so far.
+    static size_t count();
+
+private:
+    static const Entry empty_entry;
+
+    const Entry* entry_;
+};
+
+inline std::ostream& operator << (std::ostream& os, const Name& name) {
+    return os << name.str();
+}
+
+} // namespace artic
+
+namespace std {
+    template <>
+    struct hash<artic::Name> {
+        size_t operator () (const artic::Name& name) const { return name.hash(); }
+    };
+}
+
+#endif // ARTIC_INTERN_H
@@ -1,9 +1,12 @@
 #ifndef ARTIC_LEXER_H
 #define ARTIC_LEXER_H
 
-#include <unordered_map>
 #include <istream>
 #include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <utility>
 
 #include "artic/log.h"
 #include "artic/token.h"
@@ -33,10 +36,29 @@ namespace utf8 {
 /// Generates a stream of tokens for the Parser.
 class Lexer : public Logger {
 public:
-    Lexer(Log& log, const std::string& filename, std::istream& is);
+    /// Creates a lexer that reads its input from a stream.
+    /// The file identifier is the one given by the `Locator`, if any.
+    Lexer(Log& log, uint32_t file, std::istream& is);
+    /// Creates a lexer that reads its input directly from memory.
+    /// The data is not copied, and must outlive the lexer.
+    Lexer(Log& log, uint32_t file, std::string_view data);
 
     Token next();
 
+    /// Returns the location of the given range of positions in the file.
+    Loc loc(const Loc::Pos& begin, const Loc::Pos& end) const { return Loc(loc_.file, begin, end); }
+    /// Returns the location of a token produced by this lexer.
+    Loc loc(const Token& token) const { return loc(token.begin(), token.end()); }
+    /// Returns the name of an identifier produced by this lexer.
+    Name identifier(const Token& token) const { return identifiers_[token.index()]; }
+    /// Returns the value of a literal produced by this lexer.
+    const Literal& literal(const Token& token) const { return literals_[token.index()].first; }
+    /// Returns the text of a token produced by this lexer, for error messages.
+    std::string string(const Token&) const;
+
+    /// Returns the tag of the keyword with the given name, if any.
+    static std::optional<Token::Tag> find_keyword(std::string_view);
+
 private:
     struct Utf8Char {
         uint8_t bytes[utf8::max_bytes()] = {0, 0, 0, 0};
@@ -44,24 +66,39 @@ private:
     };
 
     void eat();
+    void read();
+    void eat_multibyte();
     void eat_spaces();
+    void eat_line_comment();
     void eat_comments();
     Literal parse_literal();
+    Token literal(const Loc&, const Literal&);
 
     void append();
     void append_char();
     bool accept(uint8_t);
 
+    // Fast paths that skip or append a run of ASCII characters of the given class at once
+    template <typename Class> const char* skip();
+    template <typename Class> void append();
+
     uint8_t peek(size_t i = 0) const { return cur_.bytes[i]; }
-    bool eof() const { return stream_.eof(); }
+    bool eof() const { return stream_ ? stream_->eof() : eof_; }
+    bool in_memory() const { return !stream_; }
 
-    std::istream& stream_;
+    // Input stream, or null when reading from memory
+    std::istream* stream_ = nullptr;
+    const char* ptr_ = nullptr;
+    const char* end_ = nullptr;
+    bool eof_ = false;
 
     Loc loc_;
     Utf8Char cur_;
     std::string str_;
 
-    static std::unordered_map<std::string, Token::Tag> keywords;
+    // Values of the identifiers and literals (along with their spelling) produced so far
+    std::vector<Name> identifiers_;
+    std::vector<std::pair<Literal, std::string>> literals_;
 };
 
 } // namespace artic
@@ -1,19 +1,21 @@
 #ifndef ARTIC_LOC_H
 #define ARTIC_LOC_H
 
-#include <string>
+#include <cstdint>
 #include <ostream>
-#include <memory>
 #include <cassert>
 
 namespace artic {
 
 /// Source file location.
 struct Loc {
-    std::shared_ptr<std::string> file;
-    struct {
-        int row, col;
-    } begin, end;
+    struct Pos {
+        int row = 0, col = 0;
+    };
+
+    /// File identifier, as given by the `Locator` when the file is registered.
+    uint32_t file = 0;
+    Pos begin, end;
 
     bool operator == (const Loc& loc) const {
         return
@@ -26,14 +28,17 @@ struct Loc {
     bool operator != (const Loc& loc) const { return !(*this == loc); }
 
     Loc() = default;
-    Loc(std::shared_ptr<std::string> file, int row, int col)
+    Loc(uint32_t file, int row, int col)
         : Loc(file, row, col, row, col)
     {}
-    Loc(std::shared_ptr<std::string> file, int brow, int bcol, int erow, int ecol)
+    Loc(uint32_t file, int brow, int bcol, int erow, int ecol)
         : file(file)
         , begin { brow, bcol }
         , end { erow, ecol }
     {}
+    Loc(uint32_t file, const Pos& begin, const Pos& end)
+        : file(file), begin(begin), end(end)
+    {}
     Loc(const Loc& first, const Loc& last)
         : file(first.file)
         , begin(first.begin)
@@ -49,8 +54,9 @@ struct Loc {
     Loc enlarge_before(int cols = 1) const { return Loc(file, begin.row, begin.col - cols, end.row, end.col); }
 };
 
+/// Prints the rows and columns of a location. The file name is given by the `Locator`.
 inline std::ostream& operator << (std::ostream& os, const Loc& loc) {
-    os << *loc.file << "(";
+    os << "(";
     os << loc.begin.row << ", " << loc.begin.col;
     if (loc.begin.row != loc.end.row ||
         loc.begin.col != loc.end.col) {
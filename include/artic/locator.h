@@ -1,12 +1,12 @@
 #ifndef ARTIC_LOCATOR_H
 #define ARTIC_LOCATOR_H
 
-#include <unordered_map>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <cassert>
 #include <limits>
+#include <cstdint>
 
 #include "artic/loc.h"
 #include "artic/lexer.h"
@@ -44,6 +44,21 @@ struct LocatorInfo {
         return size;
     }
 
+    /// Returns the number of columns occupied on screen by the characters of a line that precede the given column.
+    size_t width(size_t row, size_t col, size_t tab_width) const {
+        const char* line = data.data() + lines[row - 1];
+        const char* end  = data.data() + lines[row] - 1;
+        size_t width = 0;
+        for (size_t i = 0; i < col - 1; ++i) {
+            if (line < end) {
+                width += *line == '\t' ? tab_width : 1;
+                line = eat(line);
+            } else
+                width++;
+        }
+        return width;
+    }
+
     bool covers(const Loc& loc) const {
         return
             size_t(loc.end.row) < lines.size() &&
@@ -80,24 +95,31 @@ private:
 /// This class implements a system to determine the part of the original
 /// source file that is located at a given line and column position. This
 /// is used to display diagnostics that highlight error locations.
+/// Files are identified by the index given when they are registered.
 class Locator {
 public:
-    Locator()
-        : cur(info.end())
-    {}
+    /// Width of the TAB character when displaying source code, in spaces.
+    size_t tab_width = 2;
+
+    /// Registers a file and returns the identifier to use in locations that refer to it.
+    uint32_t register_file(const std::string& file, std::string_view data) {
+        files.push_back(file);
+        info.emplace_back(data);
+        return uint32_t(files.size() - 1);
+    }
 
-    const LocatorInfo* data(const std::string& file) {
-        auto it = info.find(file);
-        return it != info.end() ? &it->second : nullptr;
+    const std::string& file_name(uint32_t file) const {
+        assert(file < files.size());
+        return files[file];
     }
 
-    void register_file(const std::string& file, std::string_view data) {
-        std::tie(cur, std::ignore) = info.emplace(file, data);
+    const LocatorInfo* data(uint32_t file) const {
+        return file < info.size() ? &info[file] : nullptr;
     }
 
 private:
-    std::unordered_map<std::string, LocatorInfo> info;
-    std::unordered_map<std::string, LocatorInfo>::iterator cur;
+    std::vector<std::string> files;
+    std::vector<LocatorInfo> info;
 };
 
 } // namespace artic
@@ -2,6 +2,7 @@
 #define ARTIC_LOG_H
 
 #include <iostream>
+#include <sstream>
 #include <cstring>
 #include <cassert>
 #include <utility>
@@ -57,6 +58,27 @@ inline std::ostream& operator << (std::ostream& os, const Fill<T>& f) {
     return os;
 }
 
+/// Source text in which each TAB character is replaced by a fixed number of spaces.
+struct ExpandTabs {
+    std::string_view text;
+    size_t tab_width;
+
+    ExpandTabs(std::string_view text, size_t tab_width)
+        : text(text), tab_width(tab_width)
+    {}
+};
+
+inline std::ostream& operator << (std::ostream& os, const ExpandTabs& e) {
+    auto text = e.text;
+    for (auto pos = text.find('\t'); pos != std::string_view::npos; pos = text.find('\t')) {
+        os << text.substr(0, pos);
+        for (size_t i = 0; i < e.tab_width; ++i)
+            os << ' ';
+        text = text.substr(pos + 1);
+    }
+    return os << text;
+}
+
 enum Style {
     Normal = 0,
     Bold = 1,
@@ -133,6 +155,10 @@ Fill<T> fill(const T& t, size_t n) {
     return Fill<T>(t, n);
 }
 
+inline ExpandTabs expand_tabs(std::string_view text, size_t tab_width) {
+    return ExpandTabs(text, tab_width);
+}
+
 template <typename T> auto error_style(const T& t)    -> decltype(log::style(t, log::Style(), log::Style())) { return log::style(t, log::Style::Red, log::Style::Bold); }
 template <typename T> auto keyword_style(const T& t)  -> decltype(log::style(t, log::Style())) { return log::style(t, log::Style::Green);  }
 template <typename T> auto literal_style(const T& t)  -> decltype(log::style(t, log::Style())) { return log::style(t, log::Style::Blue);   }
@@ -169,6 +195,13 @@ void error(const char* fmt, Args&&... args) {
     out.stream << std::endl;
 }
 
+template <typename... Args>
+void warn(const char* fmt, Args&&... args) {
+    log::format(err, "{}: ", log::style("warning", log::Style::Yellow, log::Style::Bold));
+    log::format(err, fmt, std::forward<Args>(args)...);
+    err.stream << std::endl;
+}
+
 } // namespace log
 
 class Locator;
@@ -184,6 +217,9 @@ struct Log {
 
     void print_summary();
 
+    /// Appends messages produced by another log, along with their counts.
+    void append(std::string_view messages, size_t errors, size_t warns);
+
     log::Output& out;
     Locator* locator;
     size_t max_errors = 0;
@@ -191,6 +227,25 @@ struct Log {
     size_t warns;
 };
 
+/// Log that keeps its messages in memory, so that work done in parallel
+/// can report its diagnostics in a deterministic order, by replaying them.
+struct BufferedLog {
+    std::ostringstream messages;
+    log::Output out;
+    Log log;
+
+    BufferedLog(const Log& parent)
+        : out(messages, parent.out.colorized), log(out, parent.locator)
+    {
+        log.max_errors = parent.max_errors;
+    }
+
+    /// Appends the messages and counts of this log to another one.
+    void replay(Log& other) const {
+        other.append(messages.str(), log.errors, log.warns);
+    }
+};
+
 /// Base class for objects that have a log attached to them.
 struct Logger {
     Log& log;
@@ -0,0 +1,46 @@
+#ifndef ARTIC_PARALLEL_H
+#define ARTIC_PARALLEL_H
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace artic {
+
+/// Returns the number of threads used by default for parallel work.
+inline size_t default_thread_count() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/// Calls `f(i)` for every `i` in `[0, n)`, using at most `max_threads` threads (0 means the default),
+/// and returns when all calls are done. Indices are handed out one at a time, so that a few large
+/// items do not hold up the rest, and the calling thread takes part in the work.
+template <typename F>
+void parallel_for(size_t n, F&& f, size_t max_threads = 0) {
+    auto threads = std::min(max_threads > 0 ? max_threads : default_thread_count(), n);
+    if (threads <= 1) {
+        for (size_t i = 0; i < n; ++i)
+            f(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;)
+            f(i);
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool)
+        thread.join();
+}
+
+} // namespace artic
+
+#endif // ARTIC_PARALLEL_H
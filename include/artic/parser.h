@@ -111,24 +111,18 @@ private:
 
     struct Tracker {
         const Parser* parser;
-        int begin_row, begin_col;
+        Loc::Pos begin;
 
         Loc operator () () const {
-            return Loc(
-                parser->prev_.file,
-                begin_row, begin_col,
-                parser->prev_.end.row,
-                parser->prev_.end.col);
+            return parser->lexer_.loc(begin, parser->prev_);
         }
 
         Tracker(const Parser* parser, const Loc& loc)
-            : parser(parser)
-            , begin_row(loc.begin.row)
-            , begin_col(loc.begin.col)
+            : parser(parser), begin(loc.begin)
         {}
 
         Tracker(const Parser* parser)
-            : Tracker(parser, parser->ahead().loc())
+            : parser(parser), begin(parser->ahead().begin())
         {}
     };
 
@@ -160,7 +154,7 @@ private:
                     tag_list += '\'' + Token::tag_to_string(tags[i]) + '\'';
                     if (i != N - 1) tag_list += " or ";
                 }
-                error(ahead().loc(), "expected {}, got '{}'", tag_list, ahead().string());
+                error(lexer_.loc(ahead()), "expected {}, got '{}'", tag_list, lexer_.string(ahead()));
             }
             next();
             return std::distance(it, tags.begin());
@@ -170,9 +164,9 @@ private:
     bool expect(Token::Tag tag) {
         bool res = ahead().tag() == tag;
         if (!res) {
-            error(ahead().loc(), "expected '{}', got '{}'",
+            error(lexer_.loc(ahead()), "expected '{}', got '{}'",
                 Token::tag_to_string(tag),
-                ahead().string());
+                lexer_.string(ahead()));
         }
         next();
         return res;
@@ -192,7 +186,7 @@ private:
     }
 
     void next() {
-        prev_ = ahead_[0].loc();
+        prev_ = ahead_[0].end();
         for (int i = 0; i < max_ahead - 1; i++)
             ahead_[i] = ahead_[i + 1];
         ahead_[max_ahead - 1] = lexer_.next();
@@ -207,7 +201,7 @@ private:
 
     Token ahead_[max_ahead];
     Lexer& lexer_;
-    Loc prev_;
+    Loc::Pos prev_;
 };
 
 } // namespace artic
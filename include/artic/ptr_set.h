@@ -0,0 +1,93 @@
+#ifndef ARTIC_PTR_SET_H
+#define ARTIC_PTR_SET_H
+
+#include <cstddef>
+#include <cassert>
+#include <memory>
+
+namespace artic {
+
+/// Hash set of pointers using open addressing with linear probing. Elements cannot be removed.
+/// The hash of each element is stored in its slot, so that probing only dereferences
+/// the elements that have the same hash as the key.
+template <typename T, typename Hash, typename Equal>
+class PtrSet {
+public:
+    PtrSet(size_t capacity = 64)
+        : slots_(new Slot[capacity]), capacity_(capacity)
+    {
+        assert((capacity & (capacity - 1)) == 0 && "capacity must be a power of two");
+    }
+
+    PtrSet(const PtrSet&) = delete;
+    PtrSet& operator = (const PtrSet&) = delete;
+
+    /// Returns the element equal to the given key, or `nullptr` if there is none.
+    T* find(const T* key) const {
+        auto hash = Hash()(key);
+        for (size_t i = hash & (capacity_ - 1);; i = (i + 1) & (capacity_ - 1)) {
+            auto& slot = slots_[i];
+            if (!slot.ptr)
+                return nullptr;
+            if (slot.hash == hash && Equal()(slot.ptr, key))
+                return slot.ptr;
+        }
+    }
+
+    /// Inserts an element, which must not already be in the set.
+    T* insert(T* ptr) {
+        assert(!find(ptr));
+        // Keep the load factor below 3/4 so that probe sequences stay short
+        if ((size_ + 1) * 4 > capacity_ * 3)
+            rehash(capacity_ * 2);
+        place(Hash()(ptr), ptr);
+        size_++;
+        return ptr;
+    }
+
+    /// Calls the given function on every element of the set, in an unspecified order.
+    template <typename F>
+    void for_each(F&& f) const {
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].ptr)
+                f(slots_[i].ptr);
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    /// Returns the memory used by the slots of the set, in bytes.
+    size_t memory_usage() const { return capacity_ * sizeof(Slot); }
+
+private:
+    struct Slot {
+        size_t hash = 0;
+        T* ptr = nullptr;
+    };
+
+    void place(size_t hash, T* ptr) {
+        size_t i = hash & (capacity_ - 1);
+        while (slots_[i].ptr)
+            i = (i + 1) & (capacity_ - 1);
+        slots_[i] = Slot { hash, ptr };
+    }
+
+    void rehash(size_t capacity) {
+        auto old_slots = std::move(slots_);
+        auto old_capacity = capacity_;
+        slots_.reset(new Slot[capacity]);
+        capacity_ = capacity;
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old_slots[i].ptr)
+                place(old_slots[i].hash, old_slots[i].ptr);
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
+} // namespace artic
+
+#endif // ARTIC_PTR_SET_H
@@ -0,0 +1,164 @@
+#ifndef ARTIC_SERIALIZE_H
+#define ARTIC_SERIALIZE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "artic/ast.h"
+
+namespace artic {
+
+/// Tags identifying the nodes in the binary form of the AST. Nodes that derive from the same base
+/// class have consecutive tags, so that the type of a node can be checked without using RTTI.
+enum class NodeTag : uint8_t {
+    Null = 0,
+
+    Filter, TypeParamList,
+
+    PathAttr, LiteralAttr, NamedAttr, AttrList,
+
+    PrimType, TupleType, SizedArrayType, UnsizedArrayType, FnType, PtrType, TypeApp, ErrorType,
+
+    DeclStmt, ExprStmt,
+
+    TypedExpr, PathExpr, LiteralExpr, FieldExpr, RecordExpr, TupleExpr, ArrayExpr, RepeatArrayExpr,
+    FnExpr, BlockExpr, CallExpr, ProjExpr, IfExpr, CaseExpr, MatchExpr, WhileExpr, ForExpr,
+    BreakExpr, ContinueExpr, ReturnExpr, UnaryExpr, BinaryExpr, FilterExpr, CastExpr,
+    ImplicitCastExpr, AsmExpr, ErrorExpr,
+
+    TypedPtrn, IdPtrn, LiteralPtrn, FieldPtrn, RecordPtrn, CtorPtrn, TuplePtrn, ArrayPtrn, ErrorPtrn,
+
+    TypeParam, PtrnDecl, LetDecl, StaticDecl, FnDecl, FieldDecl, StructDecl, OptionDecl, EnumDecl,
+    TypeDecl, ModDecl, ErrorDecl,
+
+    FirstAttr = PathAttr,   LastAttr = AttrList,
+    FirstType = PrimType,   LastType = ErrorType,
+    FirstStmt = DeclStmt,   LastStmt = ExprStmt,
+    FirstExpr = TypedExpr,  LastExpr = ErrorExpr,
+    FirstPtrn = TypedPtrn,  LastPtrn = ErrorPtrn,
+    FirstDecl = TypeParam,  LastDecl = ErrorDecl
+};
+
+/// Writes AST nodes in a compact binary form, which can be read back with a `Deserializer`.
+/// Integers are written with a variable-length encoding, and names are only written the first time
+/// they appear, after which they are referred to by index. Locations are written relative to the
+/// previous one, and do not contain the file they belong to, since it is given when reading the nodes
+/// back. Only the information produced by the parser is written: Symbols, types, and IR definitions are not.
+/// Whether a declaration is top-level is not written either, since it only depends on where it appears.
+class Serializer {
+public:
+    /// Version of the format, to be incremented whenever the format or the AST changes.
+    static constexpr uint32_t version = 2;
+
+    /// Starts writing at the end of the given buffer, beginning with a header containing the version.
+    Serializer(std::string& buffer);
+
+    void write_uint(uint64_t u) {
+        // Most integers are small (sizes, indices, offsets), and take a single byte
+        if (u < 0x80)
+            buffer_.push_back(char(u));
+        else
+            write_long_uint(u);
+    }
+    void write_int(int64_t);
+    void write_bool(bool b) { buffer_.push_back(b ? 1 : 0); }
+    void write_string(std::string_view);
+    void write_name(Name);
+    void write_loc(const Loc&);
+    void write_id(const ast::Identifier&);
+    void write_literal(const Literal&);
+
+    template <typename T>
+    void write_ptr(const Ptr<T>& ptr) {
+        if (ptr)
+            ptr->serialize(*this);
+        else
+            write_uint(0);
+    }
+
+    template <typename T>
+    void write_ptrs(const PtrVector<T>& ptrs) {
+        write_uint(ptrs.size());
+        for (auto& ptr : ptrs)
+            write_ptr(ptr);
+    }
+
+    /// Writes the tag of a node, followed by its location and attributes.
+    void write_node(NodeTag, const ast::Node&);
+
+private:
+    void write_long_uint(uint64_t);
+
+    std::string& buffer_;
+    std::vector<uint32_t> name_indices_; ///< Index of each name, plus one, or zero if it has not been written yet
+    uint32_t name_count_ = 0;
+    Loc prev_loc_;
+};
+
+/// Reads AST nodes written by a `Serializer`. The data is read in place and is never copied,
+/// so that it can be memory-mapped. Malformed data is detected, in which case `ok()` returns false.
+class Deserializer {
+public:
+    /// Reads the header at the beginning of the data. All the locations are assigned to the given file.
+    Deserializer(std::string_view data, uint32_t file);
+
+    /// Returns true if the data has been read successfully so far.
+    bool ok() const { return ok_; }
+    /// Returns true if all the data has been read.
+    bool at_end() const { return pos_ == data_.size(); }
+
+    uint64_t read_uint() {
+        if (pos_ < data_.size() && uint8_t(data_[pos_]) < 0x80)
+            return uint8_t(data_[pos_++]);
+        return read_long_uint();
+    }
+    int64_t read_int();
+    bool read_bool() { return read_uint() != 0; }
+    std::string_view read_string();
+    Name read_name();
+    Loc read_loc();
+    ast::Identifier read_id();
+    Literal read_literal();
+    ast::Path read_path();
+
+    template <typename T>
+    T read_enum(T max) {
+        auto value = read_uint();
+        if (value > uint64_t(max))
+            return fail(), max;
+        return T(value);
+    }
+
+    /// Reads a node, which is null if the data is malformed or if it is not of the given type.
+    template <typename T> Ptr<T> read_ptr();
+    /// Reads a node that is required by the AST, which makes the data malformed if it is null.
+    template <typename T> Ptr<T> read_required_ptr();
+    /// Reads a sequence of nodes, none of which can be null.
+    template <typename T> PtrVector<T> read_ptrs();
+
+private:
+    uint64_t read_long_uint();
+    Ptr<ast::Node> read_node();
+    /// Reads the size of a sequence, which cannot be larger than the remaining data.
+    size_t read_size();
+    void fail() { ok_ = false; pos_ = data_.size(); }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+    uint32_t file_;
+    std::vector<Name> names_;
+    Loc prev_loc_;
+    bool ok_ = true;
+};
+
+/// Serializes a module, with its sub-modules, into a buffer.
+std::string serialize(const ast::ModDecl&);
+/// Reads a module back from the given data, allocating its nodes in the current arena.
+/// Returns null if the data is malformed or has been written with another version of the format.
+Ptr<ast::ModDecl> deserialize(std::string_view data, uint32_t file);
+
+} // namespace artic
+
+#endif // ARTIC_SERIALIZE_H
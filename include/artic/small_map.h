@@ -0,0 +1,123 @@
+#ifndef ARTIC_SMALL_MAP_H
+#define ARTIC_SMALL_MAP_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+namespace artic {
+
+/// Map stored as a flat array of pairs, in insertion order. The first `N` pairs are stored
+/// inline, so that small maps never allocate memory. Lookups are linear, which is faster than
+/// hashing for the handful of entries that this map is designed for.
+template <typename K, typename V, size_t N = 4>
+class SmallMap {
+public:
+    using value_type     = std::pair<K, V>;
+    using iterator       = value_type*;
+    using const_iterator = const value_type*;
+
+    SmallMap() = default;
+
+    SmallMap(const SmallMap& other) {
+        insert(other.begin(), other.end());
+    }
+
+    SmallMap(SmallMap&& other) {
+        steal(other);
+    }
+
+    SmallMap& operator = (const SmallMap& other) {
+        if (this != &other) {
+            clear();
+            insert(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallMap& operator = (SmallMap&& other) {
+        if (this != &other) {
+            clear();
+            steal(other);
+        }
+        return *this;
+    }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    iterator find(const K& key) {
+        return std::find_if(begin(), end(), [&] (const value_type& pair) { return pair.first == key; });
+    }
+
+    const_iterator find(const K& key) const {
+        return std::find_if(begin(), end(), [&] (const value_type& pair) { return pair.first == key; });
+    }
+
+    size_t count(const K& key) const { return find(key) != end() ? 1 : 0; }
+
+    /// Inserts a pair in the map, unless the key is already present.
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+        if (auto it = find(key); it != end())
+            return std::make_pair(it, false);
+        if (size_ == capacity_)
+            grow();
+        auto it = data() + size_++;
+        *it = value_type(key, V(std::forward<Args>(args)...));
+        return std::make_pair(it, true);
+    }
+
+    /// Inserts the pairs of the given range whose keys are not already present in the map.
+    template <typename It>
+    void insert(It first, It last) {
+        for (; first != last; ++first)
+            emplace(first->first, first->second);
+    }
+
+    V& operator [] (const K& key) {
+        return emplace(key).first->second;
+    }
+
+    void clear() {
+        heap_.reset();
+        size_ = 0;
+        capacity_ = N;
+    }
+
+private:
+    value_type* data() { return heap_ ? heap_.get() : inline_; }
+    const value_type* data() const { return heap_ ? heap_.get() : inline_; }
+
+    void grow() {
+        auto heap = std::make_unique<value_type[]>(capacity_ * 2);
+        std::move(begin(), end(), heap.get());
+        heap_ = std::move(heap);
+        capacity_ *= 2;
+    }
+
+    void steal(SmallMap& other) {
+        if (other.heap_) {
+            heap_ = std::move(other.heap_);
+            capacity_ = other.capacity_;
+        } else
+            std::move(other.begin(), other.end(), inline_);
+        size_ = other.size_;
+        other.clear();
+    }
+
+    value_type inline_[N];
+    std::unique_ptr<value_type[]> heap_;
+    size_t size_ = 0;
+    size_t capacity_ = N;
+};
+
+} // namespace artic
+
+#endif // ARTIC_SMALL_MAP_H
@@ -0,0 +1,75 @@
+#ifndef ARTIC_STATS_H
+#define ARTIC_STATS_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <ctime>
+#include <typeindex>
+
+#include "artic/log.h"
+
+namespace artic {
+
+/// Statistics gathered during compilation: The time spent in each pass (see `--time-passes`),
+/// and the size of the main data structures of the compiler (see `--stats`).
+struct Stats {
+    /// Time spent in a compilation pass, in seconds.
+    struct Pass {
+        std::string name;
+        double wall = 0;
+        double cpu = 0;
+    };
+
+    /// Measures the time spent in a pass, from its creation to its destruction.
+    /// Does nothing when the statistics are null or when passes are not timed.
+    class Timer {
+    public:
+        Timer(Stats* stats, std::string name)
+            : stats_(stats && stats->time_passes ? stats : nullptr), name_(std::move(name))
+            , wall_(std::chrono::steady_clock::now()), cpu_(std::clock())
+        {}
+
+        ~Timer() {
+            if (!stats_)
+                return;
+            auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_).count();
+            auto cpu  = double(std::clock() - cpu_) / CLOCKS_PER_SEC;
+            stats_->passes.push_back(Pass { std::move(name_), wall, cpu });
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator = (const Timer&) = delete;
+
+    private:
+        Stats* stats_;
+        std::string name_;
+        std::chrono::steady_clock::time_point wall_;
+        std::clock_t cpu_;
+    };
+
+    bool time_passes = false;   ///< Records the time spent in each pass
+    bool count = false;         ///< Records the counters
+
+    std::vector<Pass> passes;
+    std::vector<std::pair<std::string, size_t>> counters;
+
+    /// Adds a counter, if counters are recorded.
+    void add(std::string name, size_t value) {
+        if (count)
+            counters.emplace_back(std::move(name), value);
+    }
+
+    /// Returns a readable name for the given type, without its namespaces.
+    static std::string type_name(std::type_index);
+
+    /// Prints the statistics as a table.
+    void print(log::Output&) const;
+    /// Prints the statistics as a JSON object.
+    void print_json(std::ostream&) const;
+};
+
+} // namespace artic
+
+#endif // ARTIC_STATS_H
@@ -1,67 +1,144 @@
 #ifndef ARTIC_SYMBOL_H
 #define ARTIC_SYMBOL_H
 
-#include <unordered_map>
-#include <type_traits>
-#include <memory>
 #include <vector>
+#include <limits>
 #include <string>
 
+#include "artic/intern.h"
+
 namespace artic {
 
 namespace ast {
     struct NamedDecl;
 }
 
-/// Declaration site of a symbol.
+/// Declaration site of a symbol. Each symbol is stored in the declaration that introduces it.
 struct Symbol {
-    Symbol(ast::NamedDecl* decl) : decls{ decl } {}
-    // TODO decls seems to be only used as an option type (0 or 1 element), is there a reason to use a vec instead ? Also this ctor is dead code
-    // Symbol(std::vector<ast::NamedDecl*>&& decls) : decls(std::move(decls)) {}
-    virtual ~Symbol() {}
+    ast::NamedDecl* decl;                   ///< Declaration of the symbol
+    std::vector<ast::NamedDecl*> redecls;   ///< Invalid declarations of the same name in the same scope
+    size_t uses = 0;                        ///< Number of paths bound to the symbol
 
-    std::vector<ast::NamedDecl*> decls;
+    Symbol(ast::NamedDecl* decl) : decl(decl) {}
 };
 
-/// Table containing a map from symbol name to declaration site.
-struct SymbolTable {
-    bool top_level;
-    std::unordered_map<std::string, std::shared_ptr<Symbol>> symbols;
+/// Stack of nested scopes, mapping names to symbols.
+/// The symbols of all scopes are stored in a single stack, in which every entry points to the entry of
+/// the same name that it shadows. Each name is thus associated with a chain of entries, from its innermost
+/// declaration to its outermost one, which makes inserting, finding and popping symbols constant-time operations.
+class SymbolTable {
+public:
+    struct Binding {
+        Name name;
+        Symbol* symbol;
+        size_t shadowed;    ///< Index of the binding with the same name in an enclosing scope, if any
+    };
 
-    SymbolTable(bool top_level = false)
-        : top_level(top_level)
-    {}
+    /// Pushes a new scope. The symbols of enclosing scopes are not visible from an isolated scope.
+    void push_scope(bool top_level = false, bool isolated = false) {
+        auto visible = isolated || scopes_.empty() ? bindings_.size() : scopes_.back().visible;
+        scopes_.push_back(Scope { bindings_.size(), visible, top_level });
+    }
 
-    std::shared_ptr<Symbol> find(const std::string& name) {
-        auto it = symbols.find(name);
-        if (it != symbols.end()) return it->second;
-        return nullptr;
+    void pop_scope() {
+        for (auto first = scopes_.back().first; bindings_.size() > first; bindings_.pop_back())
+            heads_[bindings_.back().name.id()] = bindings_.back().shadowed;
+        scopes_.pop_back();
     }
 
+    bool is_top_level() const { return scopes_.back().top_level; }
+    bool empty() const { return scopes_.empty(); }
+
+    /// Bindings of the innermost scope, in declaration order.
+    const Binding* scope_begin() const { return bindings_.data() + scopes_.back().first; }
+    const Binding* scope_end() const { return bindings_.data() + bindings_.size(); }
+
+    Symbol* find(Name name) const {
+        auto index = head(name);
+        return index != npos && index >= scopes_.back().visible ? bindings_[index].symbol : nullptr;
+    }
+
+    /// Finds the symbol whose name is the closest to the given one, if its distance is lower than `min`.
+    /// Scopes are searched from the innermost to the outermost, and a symbol of an enclosing scope is
+    /// only returned if it is strictly closer than the symbols of inner scopes. The distance function must
+    /// never be lower than the difference between the lengths of its arguments, and is only called on names
+    /// whose length is close enough to that of the given name.
     template <typename T, typename DistanceFn>
-    std::pair<T, std::shared_ptr<Symbol>> find_similar(const std::string& name, T min, DistanceFn distance) {
-        std::shared_ptr<Symbol> best;
-        for (auto& symbol : symbols) {
-            auto d = distance(symbol.first, name, min);
-            if (d < min) {
-                best = symbol.second;
-                min  = d;
+    Symbol* find_similar(Name name, T min, DistanceFn distance) {
+        Symbol* best = nullptr;
+        auto size = name.size();
+        auto end = bindings_.size();
+        for (auto scope = scopes_.rbegin(); scope != scopes_.rend() && scope->first >= scopes_.back().visible; ++scope) {
+            update_length_index(*scope, end);
+            end = scope->first;
+
+            Symbol* scope_best = nullptr;
+            Name best_name;
+            // Names whose length differs by more than `min` cannot be closer (nor tie with the best name)
+            for (size_t i = size > size_t(min) ? size - size_t(min) : 0; i < scope->names_by_length.size() && i <= size + size_t(min); ++i) {
+                for (auto index : scope->names_by_length[i]) {
+                    auto& binding = bindings_[index];
+                    auto d = distance(binding.name.str(), name.str(), min);
+                    // Ties are broken with the lexicographical order, so that the result
+                    // does not depend on the order in which symbols are declared.
+                    if (d < min || (scope_best && d == min && binding.name.str() < best_name.str())) {
+                        scope_best = binding.symbol;
+                        best_name = binding.name;
+                        min = d;
+                    }
+                }
             }
+            if (scope_best)
+                best = scope_best;
         }
-        return std::make_pair(min, best);
+        return best;
     }
 
-    bool insert(const std::string& name, Symbol&& symbol) {
-        auto it = symbols.find(name);
-        if (it != symbols.end()) {
-            auto& exprs = it->second->decls;
-            exprs.insert(exprs.end(), symbol.decls.begin(), symbol.decls.end());
+    /// Inserts a symbol in the innermost scope.
+    /// Returns false if a symbol with the same name already exists in that scope.
+    bool insert(Name name, Symbol& symbol) {
+        auto index = head(name);
+        if (index != npos && index >= scopes_.back().first)
             return false;
-        }
-
-        symbols.emplace(name, std::make_shared<Symbol>(std::move(symbol)));
+        if (heads_.size() <= name.id())
+            heads_.resize(name.id() + 1, npos);
+        heads_[name.id()] = bindings_.size();
+        bindings_.push_back(Binding { name, &symbol, index });
         return true;
     }
+
+private:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    struct Scope {
+        size_t first;       ///< Index of the first binding of the scope
+        size_t visible;     ///< Index of the first binding visible from the scope
+        bool top_level;
+
+        /// Bindings of the scope, sorted by the length of their name.
+        /// This index is built lazily, since it is only needed to report errors.
+        std::vector<std::vector<size_t>> names_by_length = {};
+        size_t indexed = 0;
+    };
+
+    size_t head(Name name) const {
+        return name.id() < heads_.size() ? heads_[name.id()] : npos;
+    }
+
+    /// Adds the bindings inserted in the scope since the last call to its length index.
+    void update_length_index(Scope& scope, size_t end) {
+        for (auto index = scope.first + scope.indexed; index < end; ++index) {
+            auto size = bindings_[index].name.size();
+            if (scope.names_by_length.size() <= size)
+                scope.names_by_length.resize(size + 1);
+            scope.names_by_length[size].push_back(index);
+        }
+        scope.indexed = end - scope.first;
+    }
+
+    std::vector<Binding> bindings_;
+    std::vector<Scope> scopes_;
+    std::vector<size_t> heads_;     ///< Index of the innermost binding of each name, indexed by name identifier
 };
 
 } // namespace artic
@@ -3,9 +3,11 @@
 
 #include <string>
 #include <ostream>
+#include <cstdint>
 #include <cassert>
 
 #include "artic/loc.h"
+#include "artic/intern.h"
 
 namespace artic {
 
@@ -137,51 +139,32 @@ inline std::ostream& operator << (std::ostream& os, const Literal& lit) {
     }
 }
 
+/// Token produced by the Lexer. Tokens are trivially copyable: The value of
+/// identifiers and literals is stored in the lexer, at the index given by `index()`.
 struct Token {
 public:
-    enum Tag {
+    enum Tag : uint8_t {
 #define TAG(t, str) t,
         TOKEN_TAGS(TAG)
 #undef TAG
     };
 
     /// Constructor for invalid tokens
-    Token(const Loc& loc = Loc())
-        : Token(loc, Error)
-    {}
-
-    /// Constructor for regular tokens, taking a string (e.g. for error messages)
-    Token(const Loc& loc, Tag tag, const std::string& str)
-        : loc_(loc), tag_(tag), str_(str)
-    {}
-    /// Constructor for regular tokens
-    Token(const Loc& loc, Tag tag)
-        : Token(loc, tag, tag_to_string(tag))
-    {}
+    Token() : Token(Error, Loc()) {}
 
-    /// Constructor for literal tokens
-    Token(const Loc& loc, const std::string& str, const Literal& lit)
-        : loc_(loc), tag_(Lit), lit_(lit), str_(str)
-    {}
-
-    /// Constructor for identifiers
-    Token(const Loc& loc, const std::string& str)
-        : loc_(loc), tag_(Id), str_(str)
+    Token(Tag tag, const Loc& loc, uint32_t index = 0)
+        : tag_(tag), index_(index), begin_(loc.begin), end_(loc.end)
     {}
 
     Tag tag() const { return tag_; }
-    const Literal& literal() const { assert(is_literal()); return lit_; }
-    const std::string& identifier() const { assert(is_identifier()); return str_; }
-    const std::string& string() const { return str_; }
+    uint32_t index() const { assert(is_identifier() || is_literal()); return index_; }
+
+    const Loc::Pos& begin() const { return begin_; }
+    const Loc::Pos& end() const { return end_; }
 
     bool is_identifier() const { return tag_ == Id; }
     bool is_literal() const { return tag_ == Lit; }
 
-    const Loc& loc() const { return loc_; }
-
-    bool operator == (const Token& token) const { return token.loc_ == loc_ && token.str_ == str_; }
-    bool operator != (const Token& token) const { return token.loc_ != loc_ || token.str_ != str_; }
-
     static std::string tag_to_string(Tag tag) {
         switch (tag) {
 #define TAG(t, str) case t: return str;
@@ -193,10 +176,9 @@ public:
     }
 
 private:
-    Loc loc_;
     Tag tag_;
-    Literal lit_;
-    std::string str_;
+    uint32_t index_;
+    Loc::Pos begin_, end_;
 };
 
 } // namespace artic
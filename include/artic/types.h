@@ -2,13 +2,22 @@
 #define ARTIC_TYPES_H
 
 #include <cstddef>
+#include <climits>
 #include <unordered_set>
+#include <unordered_map>
 #include <optional>
 #include <ostream>
+#include <array>
+#include <atomic>
+#include <mutex>
 
 #include "artic/cast.h"
 #include "artic/ast.h"
 #include "artic/array.h"
+#include "artic/hash.h"
+#include "artic/arena.h"
+#include "artic/ptr_set.h"
+#include "artic/small_map.h"
 
 namespace thorin {
     class TypeTable;
@@ -21,6 +30,12 @@ struct Printer;
 class TypeTable;
 class Emitter;
 struct TypeVar;
+struct TypeSubst;
+
+/// Map from type variables to values. Polymorphic declarations rarely have
+/// more than a few type parameters, so a flat map avoids hashing and allocating.
+template <typename T>
+using TypeVarMap = SmallMap<const TypeVar*, T>;
 
 /// Variance for a type variable appearing in a type. It represents the
 /// way the type changes when the type variable changes, with respect
@@ -55,11 +70,19 @@ struct Type : public Cast<Type> {
 
     virtual void print(Printer&) const = 0;
     virtual bool equals(const Type*) const = 0;
-    virtual size_t hash() const = 0;
+    /// Computes the hash of this type. The result is stored when the type
+    /// is inserted in the type table, and is then available via `hash()`.
+    virtual size_t compute_hash() const = 0;
     virtual bool contains(const Type* type) const { return this == type; }
-    virtual const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const {
-        return this;
-    }
+
+    /// Replaces the type variables of this type according to the given map.
+    /// The result is memoized in the type table (see `TypeTable::replace()`).
+    const Type* replace(const TypeVarMap<const Type*>&) const;
+    const Type* replace(const TypeSubst&) const;
+
+    /// Applies a substitution to this type, without looking up the memoized results for this type.
+    /// The elements of this type are replaced with `replace()`, which uses memoized results.
+    virtual const Type* replace_uncached(const TypeSubst&) const { return this; }
 
     /// Converts this type to a Thorin type
     virtual const thorin::Type* convert(Emitter&) const;
@@ -68,35 +91,28 @@ struct Type : public Cast<Type> {
     virtual std::string stringify(Emitter&) const;
 
     virtual size_t order(std::unordered_set<const Type*>&) const;
-    virtual void variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const;
-    virtual void bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const;
+    virtual void variance(TypeVarMap<TypeVariance>&, bool) const;
+    virtual void bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const;
     virtual bool is_sized(std::unordered_set<const Type*>&) const;
 
     /// Returns the number of times a function type constructor is present in the type.
-    size_t order() const {
-        std::unordered_set<const Type*> seen;
-        return order(seen);
-    }
+    /// The result is computed once and stored in the type table.
+    size_t order() const;
 
     /// Computes the variance of the set of type variables that appear in this type.
-    std::unordered_map<const TypeVar*, TypeVariance> variance(bool dir = true) const {
-        std::unordered_map<const TypeVar*, TypeVariance> vars;
-        variance(vars, dir);
-        return vars;
-    }
+    /// The result is computed once and stored in the type table.
+    TypeVarMap<TypeVariance> variance(bool dir = true) const;
 
     /// Computes the bounds of the type variables that appear in this type.
-    std::unordered_map<const TypeVar*, TypeBounds> bounds(const Type* arg, bool dir = true) const {
-        std::unordered_map<const TypeVar*, TypeBounds> vars;
+    TypeVarMap<TypeBounds> bounds(const Type* arg, bool dir = true) const {
+        TypeVarMap<TypeBounds> vars;
         bounds(vars, arg, dir);
         return vars;
     }
 
     /// Returns whether this type can be represented in memory or not.
-    bool is_sized() const {
-        std::unordered_set<const Type*> seen;
-        return is_sized(seen);
-    }
+    /// The result is computed once and stored in the type table.
+    bool is_sized() const;
 
     /// Returns true if this type is a sub-type of another.
     bool subtype(const Type*) const;
@@ -104,13 +120,21 @@ struct Type : public Cast<Type> {
     /// Returns the least upper bound between this type and another.
     const Type* join(const Type*) const;
 
+    /// Returns the hash of this type, which is computed once, when the type is created.
+    size_t hash() const { return hash_; }
+
     /// Prints the type on the console, for debugging.
     void dump() const;
+
+private:
+    size_t hash_ = 0;
+
+    friend class TypeTable;
 };
 
 /// The type of an attribute.
 struct AttrType {
-    std::string name;
+    Name name;
     enum { Integer, String, Path, Other } type;
 };
 
@@ -122,7 +146,7 @@ struct PrimType : public Type {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
@@ -140,16 +164,16 @@ struct TupleType : public Type {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
     bool contains(const Type*) const override;
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
 
     size_t order(std::unordered_set<const Type*>&) const override;
-    void variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const override;
-    void bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const override;
+    void variance(TypeVarMap<TypeVariance>&, bool) const override;
+    void bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const override;
     bool is_sized(std::unordered_set<const Type*>&) const override;
 
 private:
@@ -171,8 +195,8 @@ struct ArrayType : public Type {
     bool contains(const Type*) const override;
 
     size_t order(std::unordered_set<const Type*>&) const override;
-    void variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const override;
-    void bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const override;
+    void variance(TypeVarMap<TypeVariance>&, bool) const override;
+    void bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const override;
     bool is_sized(std::unordered_set<const Type*>&) const override;
 };
 
@@ -183,9 +207,9 @@ struct SizedArrayType : public ArrayType {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
@@ -202,9 +226,9 @@ private:
 struct UnsizedArrayType : public ArrayType {
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
@@ -228,12 +252,12 @@ struct AddrType : public Type {
     {}
 
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
     bool contains(const Type*) const override;
 
     size_t order(std::unordered_set<const Type*>&) const override;
-    void variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const override;
-    void bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const override;
+    void variance(TypeVarMap<TypeVariance>&, bool) const override;
+    void bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const override;
     bool is_sized(std::unordered_set<const Type*>&) const override;
 };
 
@@ -241,7 +265,7 @@ struct AddrType : public Type {
 struct PtrType : public AddrType {
     void print(Printer&) const override;
 
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
@@ -257,7 +281,7 @@ private:
 /// The type of mutable identifiers or expressions.
 struct RefType : public AddrType {
     void print(Printer&) const override;
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
 private:
     RefType(TypeTable& type_table, const Type* pointee, bool is_mut, size_t addr_space)
@@ -274,17 +298,17 @@ struct FnType : public Type {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
     bool contains(const Type*) const override;
 
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
 
     size_t order(std::unordered_set<const Type*>&) const override;
-    void variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const override;
-    void bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const override;
+    void variance(TypeVarMap<TypeVariance>&, bool) const override;
+    void bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const override;
     bool is_sized(std::unordered_set<const Type*>&) const override;
 
 private:
@@ -299,7 +323,7 @@ private:
 struct BottomType : public Type {
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
 protected:
     BottomType(TypeTable& type_table)
@@ -313,7 +337,7 @@ protected:
 struct TopType : public Type {
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
 protected:
     TopType(TypeTable& type_table)
@@ -356,15 +380,15 @@ struct TypeVar : public Type {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
 
-    void variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const override;
-    void bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const override;
+    void variance(TypeVarMap<TypeVariance>&, bool) const override;
+    void bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const override;
 
 private:
     TypeVar(TypeTable& type_table, const ast::TypeParam& param)
@@ -385,7 +409,7 @@ struct ForallType : public Type {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
 private:
     ForallType(TypeTable& type_table, const ast::FnDecl& decl)
@@ -415,7 +439,7 @@ struct ComplexType : public UserType {
         : UserType(type_table)
     {}
 
-    virtual std::optional<size_t> find_member(const std::string_view&) const = 0;
+    virtual std::optional<size_t> find_member(Name) const = 0;
     virtual const Type* member_type(size_t) const = 0;
     virtual size_t member_count() const = 0;
 
@@ -429,14 +453,14 @@ struct StructType : public ComplexType {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
     using UserType::convert;
     const thorin::Type* convert(Emitter&, const Type*) const override;
     std::string stringify(Emitter&) const override;
 
     const ast::TypeParamList* type_params() const override;
-    std::optional<size_t> find_member(const std::string_view&) const override;
+    std::optional<size_t> find_member(Name) const override;
     const Type* member_type(size_t) const override;
     size_t member_count() const override;
 
@@ -455,7 +479,7 @@ struct EnumType : public ComplexType {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
     using UserType::convert;
     const thorin::Type* convert(Emitter&, const Type*) const override;
@@ -465,7 +489,7 @@ struct EnumType : public ComplexType {
         return decl.type_params.get();
     }
 
-    std::optional<size_t> find_member(const std::string_view&) const override;
+    std::optional<size_t> find_member(Name) const override;
     const Type* member_type(size_t) const override;
     size_t member_count() const override;
 
@@ -482,32 +506,34 @@ struct ModType : public ComplexType {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
     const ast::TypeParamList* type_params() const override { return nullptr; }
 
-    std::optional<size_t> find_member(const std::string_view&) const override;
+    std::optional<size_t> find_member(Name) const override;
     const Type* member_type(size_t) const override;
     size_t member_count() const override;
 
-    const ast::NamedDecl& member(size_t) const;
+    ast::NamedDecl& member(size_t) const;
 
 private:
-    struct Member {
-        std::string name;
-        const ast::NamedDecl& decl;
-
-        Member(const std::string& name, const ast::NamedDecl& decl)
-            : name(name), decl(decl)
-        {}
+    struct Members {
+        std::vector<ast::NamedDecl*> decls;
+        std::unordered_map<Name, size_t> indices;   ///< Index of the first member with a given name
     };
-    using Members = std::vector<Member>;
-    mutable std::unique_ptr<Members> members_;
+    // Created on first use, possibly by several threads at once (see `members()`)
+    mutable std::atomic<const Members*> members_ = nullptr;
 
     ModType(TypeTable& type_table, const ast::ModDecl& decl)
         : ComplexType(type_table), decl(decl)
     {}
 
+    ModType(ModType&& other)
+        : ComplexType(other), decl(other.decl), members_(other.members_.exchange(nullptr))
+    {}
+
+    ~ModType() { delete members_.load(); }
+
     const Members& members() const;
 
     friend class TypeTable;
@@ -518,7 +544,7 @@ struct TypeAlias : public UserType {
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
 
     const ast::TypeParamList* type_params() const override {
         return decl.type_params.get();
@@ -538,36 +564,41 @@ struct TypeApp : public Type {
     Array<const Type*> type_args;
 
     /// Gets the replacement map required to expand this type application.
-    std::unordered_map<const TypeVar*, const Type*> replace_map() const {
+    TypeVarMap<const Type*> replace_map() const {
         assert(applied->type_params());
         return replace_map(*applied->type_params(), type_args);
     }
 
+    /// Gets the substitution required to expand this type application.
+    const TypeSubst& replace_subst() const;
+
     /// Returns the type of the given member of the applied type, if it is a complex type.
-    const Type* member_type(size_t i) const {
-        return applied->as<ComplexType>()->member_type(i)->replace(replace_map());
-    }
+    const Type* member_type(size_t) const;
 
     void print(Printer&) const override;
     bool equals(const Type*) const override;
-    size_t hash() const override;
+    size_t compute_hash() const override;
     bool contains(const Type*) const override;
 
-    const Type* replace(const std::unordered_map<const TypeVar*, const Type*>&) const override;
+    const Type* replace_uncached(const TypeSubst&) const override;
 
     const thorin::Type* convert(Emitter&) const override;
     std::string stringify(Emitter&) const override;
 
     size_t order(std::unordered_set<const Type*>&) const override;
-    void variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const override;
-    void bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const override;
+    void variance(TypeVarMap<TypeVariance>&, bool) const override;
+    void bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const override;
     bool is_sized(std::unordered_set<const Type*>&) const override;
 
-    static std::unordered_map<const TypeVar*, const Type*> replace_map(
+    static TypeVarMap<const Type*> replace_map(
         const ast::TypeParamList& type_params,
         const ArrayRef<const Type*>& type_args);
 
 private:
+    // Both caches are filled on first use, possibly by several threads at once
+    mutable std::atomic<const TypeSubst*> replace_subst_ = nullptr;
+    mutable std::atomic<std::atomic<const Type*>*> member_types_ = nullptr;
+
     TypeApp(
         TypeTable& type_table,
         const UserType* applied,
@@ -577,6 +608,16 @@ private:
         , type_args(std::move(type_args))
     {}
 
+    TypeApp(TypeApp&& other)
+        : Type(other)
+        , applied(other.applied)
+        , type_args(std::move(other.type_args))
+        , replace_subst_(other.replace_subst_.load())
+        , member_types_(other.member_types_.exchange(nullptr))
+    {}
+
+    ~TypeApp() { delete[] member_types_.load(); }
+
     friend class TypeTable;
 };
 
@@ -595,11 +636,29 @@ std::pair<const TypeApp*, const T*> match_app(const Type* type) {
     return std::make_pair(nullptr, type->isa<T>());
 }
 
-/// Hash table containing all types.
+/// Substitution of type variables by types. Substitutions are created by the type table,
+/// which sorts their pairs so that equal substitutions are represented by the same object.
+struct TypeSubst {
+    using Pair = std::pair<const TypeVar*, const Type*>;
+    Array<Pair> pairs;
+    size_t hash;
+
+    /// Returns the replacement for the given type variable, or `nullptr` if there is none.
+    const Type* find(const TypeVar*) const;
+    bool empty() const { return pairs.size() == 0; }
+};
+
+/// Hash table containing all types. Types can be created and queried from several threads at once:
+/// The table is split in shards, each protected by a lock, so that threads creating unrelated
+/// types rarely wait for each other.
 class TypeTable {
 public:
+    TypeTable();
     ~TypeTable();
 
+    TypeTable(const TypeTable&) = delete;
+    TypeTable& operator = (const TypeTable&) = delete;
+
     const PrimType*         prim_type(ast::PrimType::Tag);
     const PrimType*         bool_type();
     const TupleType*        unit_type();
@@ -625,10 +684,44 @@ public:
     /// or returns the type alias expanded with the given type arguments.
     const Type* type_app(const UserType*, const ArrayRef<const Type*>&);
 
+    /// Returns the substitution corresponding to the given map.
+    const TypeSubst& subst(const TypeVarMap<const Type*>&);
+    /// Returns the substitution that maps each type parameter to the corresponding type argument.
+    const TypeSubst& subst(const ast::TypeParamList&, const ArrayRef<const Type*>&);
+
+    /// Applies a substitution to a type. Results are memoized, so that replacing
+    /// type variables in the same type several times only walks that type once.
+    const Type* replace(const Type*, const TypeSubst&);
+
+    /// Returns the variance of the type variables of a type, in the covariant direction.
+    const TypeVarMap<TypeVariance>& variance(const Type*);
+    /// Returns the order of a type (see `Type::order()`).
+    size_t order(const Type*);
+    /// Returns whether a type is sized (see `Type::is_sized()`).
+    bool is_sized(const Type*);
+
+    /// Returns the number of types created so far.
+    size_t type_count() const;
+    /// Returns the amount of memory used by the types and substitutions of this table, in bytes.
+    size_t memory_usage() const;
+
 private:
     template <typename T, typename... Args>
     const T* insert(Args&&...);
 
+    const TypeSubst& insert_subst(SmallArray<TypeSubst::Pair>&);
+
+    struct TypeInfo;
+    template <typename T, typename F>
+    const T& info(const Type*, std::optional<T> TypeInfo::*, F&&);
+
+    static constexpr size_t shard_bits = 4;
+    static constexpr size_t shard_count = size_t(1) << shard_bits;
+
+    static size_t shard_index(size_t hash) {
+        return (hash >> (sizeof(size_t) * CHAR_BIT - shard_bits)) & (shard_count - 1);
+    }
+
     struct HashType {
         size_t operator () (const Type* type) const {
             return type->hash();
@@ -639,7 +732,50 @@ private:
             return left->equals(right);
         }
     };
-    std::unordered_set<const Type*, HashType, CompareTypes> types_;
+
+    // Types are allocated in the arena of their shard, and are released all at once
+    struct TypeShard {
+        mutable std::mutex mutex;
+        Arena arena;
+        PtrSet<const Type, HashType, CompareTypes> types;
+    };
+    std::array<TypeShard, shard_count> type_shards_;
+
+    struct HashSubst {
+        size_t operator () (const TypeSubst* subst) const {
+            return subst->hash;
+        }
+    };
+    struct CompareSubsts {
+        bool operator () (const TypeSubst* left, const TypeSubst* right) const {
+            return left->pairs == right->pairs;
+        }
+    };
+
+    mutable std::mutex subst_mutex_;
+    Arena subst_arena_;
+    PtrSet<const TypeSubst, HashSubst, CompareSubsts> substs_;
+
+    struct HashReplacement {
+        size_t operator () (const std::pair<const Type*, const TypeSubst*>& pair) const noexcept {
+            return fnv::Hash().combine(pair.first->hash()).combine(pair.second->hash);
+        }
+    };
+
+    // Properties of types that are computed on demand
+    struct TypeInfo {
+        std::optional<TypeVarMap<TypeVariance>> variance;
+        std::optional<size_t> order;
+        std::optional<bool> is_sized;
+    };
+
+    // Memoized results, sharded by the hash of the type they relate to
+    struct CacheShard {
+        std::mutex mutex;
+        std::unordered_map<std::pair<const Type*, const TypeSubst*>, const Type*, HashReplacement> replacements;
+        std::unordered_map<const Type*, TypeInfo> infos;
+    };
+    std::array<CacheShard, shard_count> cache_shards_;
 
     const PrimType*   bool_type_   = nullptr;
     const TupleType*  unit_type_   = nullptr;
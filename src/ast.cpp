@@ -32,25 +32,25 @@ std::string PrimType::tag_to_string(Tag tag) {
     }
 }
 
-PrimType::Tag PrimType::tag_from_token(const Token& token) {
-    static std::unordered_map<std::string, Tag> tag_map{
-        std::make_pair("bool", Bool),
-
-        std::make_pair("i8",  I8),
-        std::make_pair("i16", I16),
-        std::make_pair("i32", I32),
-        std::make_pair("i64", I64),
-
-        std::make_pair("u8",  U8),
-        std::make_pair("u16", U16),
-        std::make_pair("u32", U32),
-        std::make_pair("u64", U64),
-
-        std::make_pair("f16", F16),
-        std::make_pair("f32", F32),
-        std::make_pair("f64", F64),
+PrimType::Tag PrimType::tag_from_name(Name name) {
+    static std::unordered_map<Name, Tag> tag_map{
+        std::make_pair(Name("bool"), Bool),
+
+        std::make_pair(Name("i8"),  I8),
+        std::make_pair(Name("i16"), I16),
+        std::make_pair(Name("i32"), I32),
+        std::make_pair(Name("i64"), I64),
+
+        std::make_pair(Name("u8"),  U8),
+        std::make_pair(Name("u16"), U16),
+        std::make_pair(Name("u32"), U32),
+        std::make_pair(Name("u64"), U64),
+
+        std::make_pair(Name("f16"), F16),
+        std::make_pair(Name("f32"), F32),
+        std::make_pair(Name("f64"), F64),
     };
-    auto it = tag_map.find(token.string());
+    auto it = tag_map.find(name);
     return it != tag_map.end() ? it->second : Error;
 }
 
@@ -268,7 +268,7 @@ BinaryExpr::Tag BinaryExpr::tag_from_token(const Token& token) {
 
 // Attributes ----------------------------------------------------------------------
 
-static const Attr* find(const PtrVector<Attr>& attrs, const std::string_view& name) {
+static const Attr* find(const PtrVector<Attr>& attrs, Name name) {
     for (auto& attr : attrs) {
         if (attr->name == name)
             return attr.get();
@@ -276,11 +276,11 @@ static const Attr* find(const PtrVector<Attr>& attrs, const std::string_view& na
     return nullptr;
 }
 
-const Attr* Attr::find(const std::string_view&) const {
+const Attr* Attr::find(Name) const {
     return nullptr;
 }
 
-const Attr* NamedAttr::find(const std::string_view& name) const {
+const Attr* NamedAttr::find(Name name) const {
     return ast::find(args, name);
 }
 
@@ -338,8 +338,8 @@ bool PathExpr::is_constant() const {
 }
 
 void PathExpr::write_to() const {
-    if (path.symbol && path.symbol->decls.size() == 1) {
-        if (auto ptrn_decl = path.symbol->decls.front()->isa<PtrnDecl>(); ptrn_decl && ptrn_decl->is_mut)
+    if (path.symbol && path.symbol->redecls.empty()) {
+        if (auto ptrn_decl = path.symbol->decl->isa<PtrnDecl>(); ptrn_decl && ptrn_decl->is_mut)
             ptrn_decl->written_to = true;
     }
 }
@@ -589,9 +589,9 @@ bool ImplicitCastExpr::is_constant() const {
     assert(expr->type);
     if (auto path_expr = expr->isa<PathExpr>();
         path_expr && path_expr->path.elems.size() == 1 &&
-        path_expr->path.symbol && !path_expr->path.symbol->decls.empty())
+        path_expr->path.symbol)
     {
-        if (auto static_decl = path_expr->path.symbol->decls.front()->isa<StaticDecl>()) {
+        if (auto static_decl = path_expr->path.symbol->decl->isa<StaticDecl>()) {
             // Allow using other constant static declarations as constants
             return !static_decl->is_mut;
         }
@@ -18,22 +18,141 @@ void NameBinder::bind(ast::Node& node) {
     node.bind(*this);
 }
 
+void NameBinder::use(const ast::Path& path) {
+    if (track_uses && cur_decl_ && path.symbol->decl->is_top_level)
+        uses_[cur_decl_].push_back(&path);
+}
+
+void NameBinder::mark_reachable(ast::ModDecl& program) {
+    static const Name export_attr_name("export");
+
+    // Modules are always reachable, since they only contain other declarations
+    std::vector<ast::Decl*> stack;
+    auto mark = [&] (ast::Decl& decl) {
+        if (!decl.is_reachable) {
+            decl.is_reachable = true;
+            stack.push_back(&decl);
+        }
+    };
+    auto mark_module = [&] (ast::ModDecl& mod_decl, auto& mark_module) -> void {
+        for (auto& decl : mod_decl.decls) {
+            if (auto inner_mod = decl->isa<ast::ModDecl>())
+                mark_module(*inner_mod, mark_module);
+            else
+                mark(*decl);
+        }
+    };
+
+    // Members of each module, indexed by name, to resolve paths of the form `A::B::f`
+    std::unordered_map<const ast::ModDecl*, std::unordered_map<Name, ast::NamedDecl*>> members;
+    std::vector<ast::Decl*> roots;
+    auto visit_module = [&] (ast::ModDecl& mod_decl, auto& visit_module) -> void {
+        auto& names = members[&mod_decl];
+        for (auto& decl : mod_decl.decls) {
+            if (auto named_decl = decl->isa<ast::NamedDecl>())
+                names.emplace(named_decl->id.name, named_decl);
+            if (auto inner_mod = decl->isa<ast::ModDecl>()) {
+                visit_module(*inner_mod, visit_module);
+                continue;
+            }
+            decl->is_reachable = false;
+            auto fn_decl = decl->isa<ast::FnDecl>();
+            auto static_decl = decl->isa<ast::StaticDecl>();
+            if ((fn_decl && fn_decl->attrs && fn_decl->attrs->find(export_attr_name)) || (static_decl && static_decl->is_mut))
+                roots.push_back(decl.get());
+        }
+    };
+    visit_module(program, visit_module);
+
+    for (auto root : roots)
+        mark(*root);
+    while (!stack.empty()) {
+        auto decl = stack.back();
+        stack.pop_back();
+        auto it = uses_.find(decl);
+        if (it == uses_.end())
+            continue;
+        for (auto path : it->second) {
+            // Follow the path through modules, to only mark the member that is used
+            ast::NamedDecl* target = path->symbol->decl;
+            for (size_t i = 1, n = path->elems.size(); i < n && target && target->isa<ast::ModDecl>(); ++i) {
+                auto& names = members[target->as<ast::ModDecl>()];
+                auto member = names.find(path->elems[i].id.name);
+                target = member != names.end() ? member->second : nullptr;
+            }
+            if (!target)
+                continue;
+            // Modules used as a whole (e.g. as types) need all their members
+            if (auto mod_decl = target->isa<ast::ModDecl>())
+                mark_module(*mod_decl, mark_module);
+            else
+                mark(*target);
+        }
+    }
+}
+
+size_t NameBinder::levenshtein(const std::string_view& a, const std::string_view& b, size_t max) {
+    if (a.size() < b.size())
+        return levenshtein(b, a, max);
+    if (a.size() - b.size() > max)
+        return max + 1;
+
+    // Only the cells that are at most `max` cells away from the diagonal can hold a distance
+    // lower than or equal to `max`, so the others are ignored. This runs in O(|b| * max).
+    // Most identifiers are short, in which case both rows are kept on the stack
+    const size_t inf = max + 1;
+    static constexpr size_t small_size = 32;
+    size_t small[2 * small_size];
+    std::vector<size_t> large;
+    auto prev = small;
+    if (b.size() >= small_size) {
+        large.resize(2 * (b.size() + 1));
+        prev = large.data();
+    }
+    auto cur = prev + b.size() + 1;
+    std::fill(prev, cur + b.size() + 1, inf);
+    for (size_t j = 0, n = std::min(b.size(), max); j <= n; ++j)
+        prev[j] = j;
+    for (size_t i = 1; i <= a.size(); ++i) {
+        auto first = i > max ? i - max : 0;
+        auto last  = std::min(b.size(), i + max);
+        auto row_min = inf;
+        if (first == 0)
+            row_min = cur[0] = i;
+        else
+            cur[first - 1] = inf;
+        for (size_t j = std::max(first, size_t(1)); j <= last; ++j) {
+            auto d = std::min(prev[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0), std::min(prev[j], cur[j - 1]) + 1);
+            cur[j] = std::min(d, inf);
+            row_min = std::min(row_min, cur[j]);
+        }
+        if (last < b.size())
+            cur[last + 1] = inf;
+        // The distance can only grow from one row to the next
+        if (row_min > max)
+            return inf;
+        std::swap(prev, cur);
+    }
+    return prev[b.size()];
+}
+
 void NameBinder::pop_scope() {
-    for (auto& pair : scopes_.back().symbols) {
-        auto decl = pair.second->decls.front();
-        if (pair.second.use_count() <= 1 &&
-            !scopes_.back().top_level &&
-            !decl->isa<ast::FieldDecl>() &&
-            !decl->isa<ast::OptionDecl>()) {
-            warn(decl->loc, "unused identifier '{}'", pair.first);
-            note("prefix unused identifiers with '_'");
+    if (!symbols_.is_top_level()) {
+        for (auto binding = symbols_.scope_begin(); binding != symbols_.scope_end(); ++binding) {
+            auto decl = binding->symbol->decl;
+            if (binding->symbol->uses == 0 &&
+                !decl->isa<ast::FieldDecl>() &&
+                !decl->isa<ast::OptionDecl>()) {
+                warn(decl->loc, "unused identifier '{}'", binding->name);
+                note("prefix unused identifiers with '_'");
+            }
         }
     }
-    scopes_.pop_back();
+    symbols_.pop_scope();
 }
 
 void NameBinder::insert_symbol(ast::NamedDecl& decl) {
-    assert(!scopes_.empty());
+    assert(!symbols_.empty());
     auto& name = decl.id.name;
     assert(!name.empty());
 
@@ -41,17 +160,19 @@ void NameBinder::insert_symbol(ast::NamedDecl& decl) {
     if (name[0] == '_') return;
 
     auto shadow_symbol = find_symbol(name);
-    if (!scopes_.back().insert(name, Symbol(&decl))) {
+    if (!symbols_.insert(name, decl.symbol)) {
         error(decl.loc, "identifier '{}' already declared", name);
-        for (auto other : shadow_symbol->decls) {
+        note(shadow_symbol->decl->loc, "previously declared here");
+        for (auto other : shadow_symbol->redecls) {
             if (other != &decl) note(other->loc, "previously declared here");
         }
+        shadow_symbol->redecls.push_back(&decl);
     } else if (
         warn_on_shadowing && shadow_symbol &&
         decl.isa<ast::PtrnDecl>() &&
-        !shadow_symbol->decls[0]->is_top_level) {
+        !shadow_symbol->decl->is_top_level) {
         warn(decl.loc, "declaration shadows identifier '{}'", name);
-        note(shadow_symbol->decls[0]->loc, "previously declared here");
+        note(shadow_symbol->decl->loc, "previously declared here");
     }
 }
 
@@ -68,12 +189,13 @@ void Path::bind(NameBinder& binder) {
         // TODO this assumes symbols are always the first element of a path
         // question: can paths of length > 2 even exist currently? afaik the only case of length 1 paths currently is enums...
         symbol = binder.find_symbol(first.id.name);
-        if (!symbol) {
+        if (symbol) {
+            symbol->uses++;
+            binder.use(*this);
+        } else {
             binder.error(first.id.loc, "unknown identifier '{}'", first.id.name);
-            if (auto similar = binder.find_similar_symbol(first.id.name)) {
-                auto decl = similar->decls.front();
-                binder.note("did you mean '{}'?", decl->id.name);
-            }
+            if (auto similar = binder.find_similar_symbol(first.id.name))
+                binder.note("did you mean '{}'?", similar->decl->id.name);
         }
     }
     // Bind the type arguments of each element
@@ -464,12 +586,14 @@ void ModDecl::bind_head(NameBinder& binder) {
 
 void ModDecl::bind(NameBinder& binder) {
     // Symbols defined outside the module are not visible inside it.
-    std::vector<SymbolTable> old;
-    std::swap(binder.scopes_, old);
-    binder.push_scope();
+    binder.push_scope(true, true);
     for (auto& decl : decls) binder.bind_head(*decl);
-    for (auto& decl : decls) binder.bind(*decl);
-    std::swap(binder.scopes_, old);
+    for (auto& decl : decls) {
+        auto old = binder.push_decl(decl.get());
+        binder.bind(*decl);
+        binder.pop_decl(old);
+    }
+    binder.pop_scope();
 }
 
 void ErrorDecl::bind(NameBinder&) {}
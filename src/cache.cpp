@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include "artic/build_id.h"
+#include "artic/cache.h"
+#include "artic/file.h"
+#include "artic/hash.h"
+#include "artic/serialize.h"
+
+namespace artic {
+
+std::string Cache::default_dir() {
+    if (auto dir = std::getenv("XDG_CACHE_HOME"); dir && *dir)
+        return std::string(dir) + "/artic";
+    if (auto home = std::getenv("HOME"); home && *home)
+        return std::string(home) + "/.cache/artic";
+    return std::string();
+}
+
+std::string Cache::entry(std::string_view data) const {
+    // The version of the format and the identifier of the build are part of the hash, so that
+    // entries written by other builds of the compiler (e.g. with another parser) are never read back
+    size_t hash = fnv::Hash()
+        .combine(Serializer::version)
+        .combine(std::string_view(ARTIC_BUILD_ID))
+        .combine(data);
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016zx-%zu.ast", hash, data.size());
+    return dir_ + "/" + name;
+}
+
+Ptr<ast::ModDecl> Cache::load(std::string_view data, uint32_t file) const {
+    // The entry is memory-mapped, and the deserializer reads it in place
+    MappedFile entry_file;
+    if (!entry_file.open(entry(data), true))
+        return nullptr;
+    auto buffer = entry_file.data();
+    if (buffer.size() < sizeof(size_t))
+        return nullptr;
+    auto contents = buffer.substr(0, buffer.size() - sizeof(size_t));
+    size_t hash;
+    std::memcpy(&hash, buffer.data() + contents.size(), sizeof(size_t));
+    if (hash != fnv::Hash().combine(contents))
+        return nullptr;
+    return deserialize(contents, file);
+}
+
+void Cache::store(std::string_view data, const ast::ModDecl& mod_decl) const {
+    std::error_code error;
+    std::filesystem::create_directories(dir_, error);
+    if (error)
+        return;
+
+    // Files are only stored the second time they are parsed with the same contents, so that
+    // files that change between every compilation never pay for serialization: The first
+    // time, an empty entry is written instead, which `load()` treats as a missing one.
+    auto path = entry(data);
+    if (!std::filesystem::exists(path, error)) {
+        write(path, std::string_view());
+        return;
+    }
+
+    // Entries end with a hash of their contents, so that corrupted entries are detected
+    auto buffer = serialize(mod_decl);
+    size_t hash = fnv::Hash().combine(std::string_view(buffer));
+    buffer.append(reinterpret_cast<const char*>(&hash), sizeof(size_t));
+    write(path, buffer);
+}
+
+void Cache::write(const std::string& path, std::string_view contents) const {
+    // The entry is written to a temporary file first, and then renamed, so that concurrent
+    // compilations never see an entry that is only partially written, and so that entries
+    // that are memory-mapped by another compilation are never modified
+    std::error_code error;
+    auto tmp_path = path + "." +
+        std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream os(tmp_path, std::ios::binary);
+        if (!os.write(contents.data(), contents.size()) || !os.flush()) {
+            os.close();
+            std::filesystem::remove(tmp_path, error);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp_path, path, error);
+    if (error)
+        std::filesystem::remove(tmp_path, error);
+}
+
+} // namespace artic
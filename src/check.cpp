@@ -1,11 +1,51 @@
 #include <algorithm>
 
 #include "artic/check.h"
+#include "artic/parallel.h"
 
 namespace artic {
 
-bool TypeChecker::run(ast::ModDecl& module) {
-    module.infer(*this);
+bool TypeChecker::run(ast::ModDecl& module, size_t max_threads) {
+    // Declarations are inferred first, without the bodies of the functions that have a return type.
+    // Those bodies then no longer depend on each other, and are checked in parallel, each with its own log.
+    BufferedLog decl_log(log);
+    TypeChecker decl_checker(decl_log.log, type_table);
+    decl_checker.warns_as_errors = warns_as_errors;
+    decl_checker.diagnostics = diagnostics;
+    decl_checker.collect_bodies(module);
+    module.infer(decl_checker);
+
+    auto& bodies = decl_checker.bodies_;
+    std::vector<std::unique_ptr<BufferedLog>> body_logs(bodies.size());
+    parallel_for(bodies.size(), [&] (size_t i) {
+        body_logs[i] = std::make_unique<BufferedLog>(log);
+        TypeChecker body_checker(body_logs[i]->log, type_table);
+        body_checker.warns_as_errors = warns_as_errors;
+        body_checker.diagnostics = diagnostics;
+        body_checker.check_body(*bodies[i].fn_decl);
+    }, max_threads);
+
+    // Diagnostics are replayed in the same order as if each body had been checked along with
+    // its declaration, so that the output does not depend on scheduling.
+    auto messages = decl_log.messages.str();
+    DeferredBody last { nullptr, 0, 0, 0 };
+    auto replay_decls = [&] (const DeferredBody& next) {
+        auto text = std::string_view(messages).substr(last.offset, next.offset - last.offset);
+        // Remove the separator that was added because of the previous declaration messages
+        if (!text.empty() && (last.errors > 0 || last.warns > 0))
+            text.remove_prefix(1);
+        log.append(text, next.errors - last.errors, next.warns - last.warns);
+        last = next;
+    };
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        replay_decls(bodies[i]);
+        body_logs[i]->replay(log);
+        errors += body_logs[i]->log.errors;
+        warns  += body_logs[i]->log.warns;
+    }
+    replay_decls(DeferredBody { nullptr, messages.size(), decl_log.log.errors, decl_log.log.warns });
+    errors += decl_checker.errors;
+    warns  += decl_checker.warns;
     return errors == 0;
 }
 
@@ -22,6 +62,30 @@ void TypeChecker::exit_decl(const ast::Decl* decl) {
     decls_.erase(decl);
 }
 
+void TypeChecker::collect_bodies(ast::ModDecl& module) {
+    for (auto& decl : module.decls) {
+        if (auto mod_decl = decl->isa<ast::ModDecl>())
+            collect_bodies(*mod_decl);
+        else if (auto fn_decl = decl->isa<ast::FnDecl>(); fn_decl && fn_decl->fn->ret_type && fn_decl->fn->body)
+            deferred_.emplace(fn_decl);
+    }
+}
+
+void TypeChecker::check_body(ast::FnDecl& fn_decl) {
+    enter_decl(&fn_decl);
+    check(*fn_decl.fn->body, fn_decl.fn->type->as<FnType>()->codom);
+    exit_decl(&fn_decl);
+}
+
+bool TypeChecker::defer_body(ast::FnDecl& fn_decl) {
+    if (!deferred_.count(&fn_decl))
+        return false;
+    bodies_.push_back(DeferredBody {
+        &fn_decl, size_t(log.out.stream.tellp()), log.errors, log.warns
+    });
+    return true;
+}
+
 // Error messages ------------------------------------------------------------------
 
 bool TypeChecker::should_report_error(const Type* type) {
@@ -46,7 +110,7 @@ const Type* TypeChecker::type_expected(const Loc& loc, const artic::Type* type,
     return type_table.type_error();
 }
 
-const Type* TypeChecker::unknown_member(const Loc& loc, const UserType* user_type, const std::string_view& member) {
+const Type* TypeChecker::unknown_member(const Loc& loc, const UserType* user_type, Name member) {
     error(loc, "no member '{}' in '{}'", member, *user_type);
     return type_table.type_error();
 }
@@ -116,7 +180,7 @@ void TypeChecker::invalid_constraint(const Loc& loc, const TypeVar* var, const T
     }
 }
 
-void TypeChecker::invalid_attr(const Loc& loc, const std::string_view& name) {
+void TypeChecker::invalid_attr(const Loc& loc, Name name) {
     error(loc, "invalid attribute '{}'", name);
 }
 
@@ -389,7 +453,7 @@ void TypeChecker::check_refutability(const ast::Ptrn& ptrn, bool must_be_trivial
 }
 
 bool TypeChecker::check_attrs(const ast::NamedAttr& named_attr, const ArrayRef<AttrType>& attr_types) {
-    std::unordered_map<std::string_view, const ast::Attr*> seen;
+    std::unordered_map<Name, const ast::Attr*> seen;
     for (auto& attr : named_attr.args) {
         if (!seen.emplace(attr->name, attr.get()).second) {
             error(attr->loc, "redeclaration of attribute '{}'", attr->name);
@@ -569,12 +633,20 @@ const artic::Type* Ptrn::check(TypeChecker& checker, const artic::Type* expected
 // Path ----------------------------------------------------------------------------
 
 const artic::Type* Path::infer(TypeChecker& checker, bool value_expected, Ptr<Expr>* arg) {
-    if (!symbol || symbol->decls.empty())
+    if (!symbol)
         return checker.type_table.type_error();
 
-    type = checker.infer(*symbol->decls.front());
-    is_value = elems.size() == 1 && symbol->decls.front()->isa<ValueDecl>();
-    is_ctor  = symbol->decls.front()->isa<CtorDecl>();
+    // Modules that only appear as a prefix of the path are not inferred as a whole:
+    // Only the members that are referred to are inferred on demand.
+    auto infer_decl = [&] (ast::NamedDecl& decl, bool is_last) -> const artic::Type* {
+        if (auto mod_decl = decl.isa<ModDecl>(); mod_decl && !is_last)
+            return checker.type_table.mod_type(*mod_decl);
+        return checker.infer(decl);
+    };
+
+    type = infer_decl(*symbol->decl, elems.size() == 1);
+    is_value = elems.size() == 1 && symbol->decl->isa<ValueDecl>();
+    is_ctor  = symbol->decl->isa<CtorDecl>();
 
     // Inspect every element of the path
     for (size_t i = 0, n = elems.size(); i < n; ++i) {
@@ -649,7 +721,7 @@ const artic::Type* Path::infer(TypeChecker& checker, bool value_expected, Ptr<Ex
                 if (!index)
                     return checker.unknown_member(elem.loc, mod_type, elems[i + 1].id.name);
                 elems[i + 1].index = *index;
-                type = mod_type->member_type(*index);
+                type = infer_decl(mod_type->member(*index), i + 1 == n - 1);
                 is_value = mod_type->member(*index).isa<ValueDecl>();
                 is_ctor  = mod_type->member(*index).isa<CtorDecl>();
             } else {
@@ -681,10 +753,15 @@ const artic::Type* Filter::check(TypeChecker& checker, const artic::Type* expect
 
 // Attributes ----------------------------------------------------------------------
 
+static const Name export_attr_name("export");
+static const Name import_attr_name("import");
+static const Name name_attr_name("name");
+static const Name cc_attr_name("cc");
+
 void NamedAttr::check(TypeChecker& checker, const ast::Node* node) {
-    if (name == "export" || name == "import") {
+    if (name == export_attr_name || name == import_attr_name) {
         if (auto fn_decl = node->isa<FnDecl>()) {
-            if (name == "export") {
+            if (name == export_attr_name) {
                 auto fn_type = fn_decl->type->isa<artic::FnType>();
                 if (!fn_type)
                     checker.error(fn_decl->loc, "polymorphic functions cannot be exported");
@@ -693,16 +770,16 @@ void NamedAttr::check(TypeChecker& checker, const ast::Node* node) {
                 else if (!fn_decl->fn->body)
                     checker.error(fn_decl->loc, "exported functions must have a body");
                 else
-                    checker.check_attrs(*this, { { "name", AttrType::String } });
-            } else if (name == "import") {
+                    checker.check_attrs(*this, { { name_attr_name, AttrType::String } });
+            } else if (name == import_attr_name) {
                 if (checker.check_attrs(*this, std::array<AttrType, 2> {
-                        AttrType { "cc", AttrType::String },
-                        AttrType { "name", AttrType::String }
+                        AttrType { cc_attr_name, AttrType::String },
+                        AttrType { name_attr_name, AttrType::String }
                     })) {
-                    auto name = fn_decl->id.name;
-                    if (auto name_attr = find("name"))
+                    auto name = fn_decl->id.name.str();
+                    if (auto name_attr = find(name_attr_name))
                         name = name_attr->as<LiteralAttr>()->lit.as_string();
-                    if (auto cc_attr = find("cc")) {
+                    if (auto cc_attr = find(cc_attr_name)) {
                         auto& cc = cc_attr->as<LiteralAttr>()->lit.as_string();
                         if (cc == "builtin") {
                             if (name != "alignof" && name != "bitcast" && name != "insert" &&
@@ -1471,7 +1548,7 @@ const artic::Type* FnDecl::infer(TypeChecker& checker) {
     fn->type = fn_type;
     if (forall)
         forall->as<ForallType>()->body = fn_type;
-    if (fn->ret_type && fn->body)
+    if (fn->ret_type && fn->body && !checker.defer_body(*this))
         checker.check(*fn->body, fn_type->as<artic::FnType>()->codom);
     checker.exit_decl(this);
     return type;
@@ -1554,8 +1631,10 @@ const artic::Type* TypeDecl::infer(TypeChecker& checker) {
 }
 
 const artic::Type* ModDecl::infer(TypeChecker& checker) {
-    for (auto& decl : decls)
-        checker.infer(*decl);
+    for (auto& decl : decls) {
+        if (decl->is_reachable)
+            checker.infer(*decl);
+    }
     return checker.type_table.mod_type(*this);
 }
 
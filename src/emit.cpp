@@ -6,11 +6,16 @@
 #include "artic/parser.h"
 #include "artic/bind.h"
 #include "artic/check.h"
+#include "artic/parallel.h"
+#include "artic/cache.h"
+#include "artic/serialize.h"
 
 #include <thorin/def.h>
 #include <thorin/type.h>
 #include <thorin/world.h>
 
+#include <numeric>
+
 namespace artic {
 
 /// Pattern matching compiler inspired from
@@ -697,7 +702,7 @@ void Emitter::bind(const ast::IdPtrn& id_ptrn, const thorin::Def* value) {
             warn(id_ptrn.loc, "mutable variable '{}' is never written to", id_ptrn.decl->id.name);
     } else {
         id_ptrn.decl->def = value;
-        value->debug().set(id_ptrn.decl->id.name);
+        value->debug().set(std::string(id_ptrn.decl->id.name.str()));
     }
 }
 
@@ -764,9 +769,9 @@ const thorin::Def* Emitter::builtin(const ast::FnDecl& fn_decl, thorin::Continua
     return cont;
 }
 
-static inline thorin::Location location(const Loc& loc) {
+static inline thorin::Location location(const Locator* locator, const Loc& loc) {
     return thorin::Location(
-        loc.file->c_str(),
+        locator ? locator->file_name(loc.file).c_str() : "<unknown>",
         loc.begin.row,
         loc.begin.col,
         loc.end.row,
@@ -774,13 +779,13 @@ static inline thorin::Location location(const Loc& loc) {
 }
 
 thorin::Debug Emitter::debug_info(const ast::NamedDecl& decl) {
-    return thorin::Debug { location(decl.loc), decl.id.name };
+    return thorin::Debug { location(log.locator, decl.loc), std::string(decl.id.name.str()) };
 }
 
 thorin::Debug Emitter::debug_info(const ast::Node& node, const std::string_view& name) {
     if (auto named_decl = node.isa<ast::NamedDecl>(); named_decl && name == "")
         return debug_info(*named_decl);
-    return thorin::Debug { location(node.loc), std::string(name) };
+    return thorin::Debug { location(log.locator, node.loc), std::string(name) };
 }
 
 namespace ast {
@@ -794,20 +799,20 @@ const thorin::Def* Node::emit(Emitter&) const {
 
 const thorin::Def* Path::emit(Emitter& emitter) const {
     // Currently only supports paths of the form A/A::B/A[T, ...]/A[T, ...]::B
-    if (auto struct_decl = symbol->decls.front()->isa<StructDecl>();
+    if (auto struct_decl = symbol->decl->isa<StructDecl>();
         struct_decl && struct_decl->is_tuple_like && struct_decl->fields.empty()) {
         return emitter.world.struct_agg(
             type->convert(emitter)->as<thorin::StructType>(), {},
             emitter.debug_info(*this));
     }
 
-    const auto* decl = symbol->decls.front();
+    const auto* decl = symbol->decl;
     for (size_t i = 0, n = elems.size(); i < n; ++i) {
         if (auto mod_type = elems[i].type->isa<ModType>()) {
             decl = &mod_type->member(elems[i + 1].index);
         } else if (!is_ctor) {
             // If type arguments are present, this is a polymorphic application
-            std::unordered_map<const artic::TypeVar*, const artic::Type*> map;
+            artic::TypeVarMap<const artic::Type*> map;
             if (!elems[i].inferred_args.empty()) {
                 for (size_t j = 0, n = elems[i].inferred_args.size(); j < n; ++j) {
                     auto var = decl->as<FnDecl>()->type_params->params[j]->type->as<artic::TypeVar>();
@@ -1041,7 +1046,7 @@ const thorin::Def* ProjExpr::emit(Emitter& emitter) const {
 static inline std::pair<Ptr<IdPtrn>, Ptr<TupleExpr>> dummy_case(const Loc& loc, const artic::Type* type) {
     // Create a dummy wildcard pattern '_' and empty tuple '()'
     // for the else/break branches of an `if let`/`while let`.
-    auto anon_decl   = make_ptr<ast::PtrnDecl>(loc, Identifier(loc, "_"), false);
+    auto anon_decl   = make_ptr<ast::PtrnDecl>(loc, Identifier(loc, Name("_")), false);
     auto anon_ptrn   = make_ptr<ast::IdPtrn>(loc, std::move(anon_decl), nullptr);
     auto empty_tuple = make_ptr<ast::TupleExpr>(loc, PtrVector<ast::Expr>());
     anon_ptrn->type  = type;
@@ -1395,14 +1400,18 @@ const thorin::Def* FnDecl::emit(Emitter& emitter) const {
 
     // Set the calling convention and export the continuation if needed
     if (attrs) {
-        if (auto export_attr = attrs->find("export")) {
+        static const Name export_attr_name("export");
+        static const Name import_attr_name("import");
+        static const Name name_attr_name("name");
+        static const Name cc_attr_name("cc");
+        if (auto export_attr = attrs->find(export_attr_name)) {
             cont->make_exported();
-            if (auto name_attr = export_attr->find("name"))
+            if (auto name_attr = export_attr->find(name_attr_name))
                 cont->debug().set(name_attr->as<LiteralAttr>()->lit.as_string());
-        } else if (auto import_attr = attrs->find("import")) {
-            if (auto name_attr = import_attr->find("name"))
+        } else if (auto import_attr = attrs->find(import_attr_name)) {
+            if (auto name_attr = import_attr->find(name_attr_name))
                 cont->debug().set(name_attr->as<LiteralAttr>()->lit.as_string());
-            if (auto cc_attr = import_attr->find("cc")) {
+            if (auto cc_attr = import_attr->find(cc_attr_name)) {
                 auto cc = cc_attr->as<LiteralAttr>()->lit.as_string();
                 if (cc == "device") {
                     cont->attributes().cc = thorin::CC::Device;
@@ -1461,6 +1470,9 @@ const thorin::Def* ModDecl::emit(Emitter& emitter) const {
         // the call site, where the type arguments are known.
         if (auto fn_decl = decl->isa<FnDecl>(); fn_decl && fn_decl->type_params)
             continue;
+        // Unreachable declarations are not type-checked (see `NameBinder::mark_reachable()`)
+        if (!decl->is_reachable)
+            continue;
         emitter.emit(*decl);
     }
     return nullptr;
@@ -1640,8 +1652,8 @@ inline std::string stringify_params(
 
 std::string StructType::stringify(Emitter& emitter) const {
     if (!type_params())
-        return decl.id.name;
-    return stringify_params(emitter, decl.id.name + "_", type_params()->params);
+        return std::string(decl.id.name.str());
+    return stringify_params(emitter, std::string(decl.id.name.str()) + "_", type_params()->params);
 }
 
 const thorin::Type* StructType::convert(Emitter& emitter, const Type* parent) const {
@@ -1651,15 +1663,15 @@ const thorin::Type* StructType::convert(Emitter& emitter, const Type* parent) co
     emitter.types[parent] = type;
     for (size_t i = 0, n = decl.fields.size(); i < n; ++i) {
         type->set(i, decl.fields[i]->ast::Node::type->convert(emitter));
-        type->set_op_name(i, decl.fields[i]->id.name.empty() ? "_" + std::to_string(i) : decl.fields[i]->id.name);
+        type->set_op_name(i, decl.fields[i]->id.name.empty() ? "_" + std::to_string(i) : std::string(decl.fields[i]->id.name.str()));
     }
     return type;
 }
 
 std::string EnumType::stringify(Emitter& emitter) const {
     if (!decl.type_params)
-        return decl.id.name;
-    return stringify_params(emitter, decl.id.name + "_", decl.type_params->params);
+        return std::string(decl.id.name.str());
+    return stringify_params(emitter, std::string(decl.id.name.str()) + "_", decl.type_params->params);
 }
 
 const thorin::Type* EnumType::convert(Emitter& emitter, const Type* parent) const {
@@ -1669,7 +1681,7 @@ const thorin::Type* EnumType::convert(Emitter& emitter, const Type* parent) cons
     emitter.types[parent] = type;
     for (size_t i = 0, n = decl.options.size(); i < n; ++i) {
         type->set(i, decl.options[i]->type->convert(emitter));
-        type->set_op_name(i, decl.options[i]->id.name);
+        type->set_op_name(i, std::string(decl.options[i]->id.name.str()));
     }
     return type;
 }
@@ -1700,82 +1712,158 @@ const thorin::Type* TypeApp::convert(Emitter& emitter) const {
     return result;
 }
 
-// A read-only buffer from memory, not performing any copy.
-struct MemBuf : public std::streambuf {
-    MemBuf(const std::string& str) {
-        setg(
-            const_cast<char*>(str.data()),
-            const_cast<char*>(str.data()),
-            const_cast<char*>(str.data() + str.size()));
-    }
-
-    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode) override {
-        if (way == std::ios_base::beg)
-            setg(eback(), eback() + off, egptr());
-        else if (way == std::ios_base::cur)
-            setg(eback(), gptr() + off, egptr());
-        else if (way == std::ios_base::end)
-            setg(eback(), egptr() + off, egptr());
-        else
-            return std::streampos(-1);
-        return gptr() - eback();
-    }
-
-    std::streampos seekpos(std::streampos pos, std::ios_base::openmode mode) override {
-        return seekoff(std::streamoff(pos), std::ios_base::beg, mode);
-    }
-
-    std::streamsize showmanyc() override {
-        return egptr() - gptr();
-    }
-};
-
 bool compile(
     const std::vector<std::string>& file_names,
-    const std::vector<std::string>& file_data,
+    const std::vector<std::string_view>& file_data,
     bool warns_as_errors,
     bool enable_all_warns,
+    bool reachable_only,
     ast::ModDecl& program,
     thorin::World& world,
     thorin::Log::Level log_level,
-    Log& log) {
+    Log& log,
+    Stats* stats,
+    const Cache* cache,
+    bool round_trip_ast) {
     assert(file_data.size() == file_names.size());
-    for (size_t i = 0, n = file_names.size(); i < n; ++i) {
-        if (log.locator)
-            log.locator->register_file(file_names[i], file_data[i]);
-        MemBuf mem_buf(file_data[i]);
-        std::istream is(&mem_buf);
-
-        Lexer lexer(log, file_names[i], is);
-        Parser parser(log, lexer);
-        parser.warns_as_errors = warns_as_errors;
-        auto module = parser.parse();
+
+    // All the nodes created during compilation are allocated in the arena of the program
+    if (!program.arena)
+        program.arena = std::make_unique<Arena>();
+    Arena::Scope arena_scope(*program.arena);
+    bool count = stats && stats->count;
+    if (count)
+        program.arena->enable_counts();
+
+    // Files are registered up front, so that the locator is only read while parsing
+    auto file_count = file_names.size();
+    std::vector<uint32_t> files(file_count);
+    for (size_t i = 0; i < file_count; ++i)
+        files[i] = log.locator ? log.locator->register_file(file_names[i], file_data[i]) : uint32_t(i);
+
+    // Lexing is interleaved with parsing, so it is measured with a separate pass
+    // that only lexes the files, and whose diagnostics are reported by the parser.
+    if (stats && (stats->time_passes || stats->count)) {
+        std::vector<size_t> token_counts(file_count);
+        {
+            Stats::Timer timer(stats, "lex");
+            parallel_for(file_count, [&] (size_t i) {
+                std::ostream null_stream(nullptr);
+                log::Output out(null_stream, false);
+                Log file_log(out);
+                Lexer lexer(file_log, files[i], file_data[i]);
+                while (lexer.next().tag() != Token::End)
+                    token_counts[i]++;
+            });
+        }
+        stats->add("tokens", std::accumulate(token_counts.begin(), token_counts.end(), size_t(0)));
+    }
+
+    // Each file is parsed on its own thread, in its own arena, and with its own buffered log
+    struct ParsedFile {
+        Arena arena;
+        std::unique_ptr<BufferedLog> log;
+        Ptr<ast::ModDecl> module;
+        bool cached = false;
+    };
+    std::vector<ParsedFile> parsed(file_count);
+    {
+        Stats::Timer timer(stats, "parse");
+        parallel_for(file_count, [&] (size_t i) {
+            auto& result = parsed[i];
+            if (count)
+                result.arena.enable_counts();
+            Arena::Scope file_arena_scope(result.arena);
+            result.log = std::make_unique<BufferedLog>(log);
+            if (cache && (result.module = cache->load(file_data[i], files[i]))) {
+                result.cached = true;
+                return;
+            }
+            Lexer lexer(result.log->log, files[i], file_data[i]);
+            Parser parser(result.log->log, lexer);
+            parser.warns_as_errors = warns_as_errors;
+            result.module = parser.parse();
+            // Files with diagnostics are not cached, since their diagnostics would be lost
+            if (cache && result.log->log.errors == 0 && result.log->log.warns == 0)
+                cache->store(file_data[i], *result.module);
+            if (round_trip_ast) {
+                auto data = serialize(*result.module);
+                if (auto module = deserialize(data, files[i]))
+                    result.module = std::move(module);
+                else
+                    parser.error(result.module->loc, "cannot read back the serialized AST");
+            }
+        });
+    }
+    if (cache && stats) {
+        stats->add("cached files", std::count_if(parsed.begin(), parsed.end(), [] (auto& result) {
+            return result.cached;
+        }));
+    }
+
+    // Diagnostics are replayed and declarations merged in input order, stopping at the first
+    // file that has errors, so that the output is the same as when parsing files one by one.
+    for (auto& result : parsed) {
+        result.log->replay(log);
         if (log.errors > 0)
             return false;
 
         program.decls.insert(
             program.decls.end(),
-            std::make_move_iterator(module->decls.begin()),
-            std::make_move_iterator(module->decls.end())
+            std::make_move_iterator(result.module->decls.begin()),
+            std::make_move_iterator(result.module->decls.end())
         );
+        result.module.reset();
+        program.arena->merge(result.arena);
+    }
+
+    if (count) {
+        // Only the nodes created by the parser are counted, not those inserted later (e.g. implicit casts)
+        size_t node_count = 0;
+        std::vector<std::pair<std::string, size_t>> node_counts;
+        for (auto& pair : *program.arena->counts()) {
+            node_counts.emplace_back(Stats::type_name(pair.first), pair.second);
+            node_count += pair.second;
+        }
+        std::sort(node_counts.begin(), node_counts.end());
+        stats->add("ast nodes", node_count);
+        for (auto& pair : node_counts)
+            stats->add("ast nodes/" + pair.first, pair.second);
     }
 
     NameBinder name_binder(log);
     name_binder.warns_as_errors = warns_as_errors;
     if (enable_all_warns)
         name_binder.warn_on_shadowing = true;
+    name_binder.track_uses = reachable_only;
+    {
+        Stats::Timer timer(stats, "bind");
+        if (!name_binder.run(program))
+            return false;
+        if (reachable_only)
+            name_binder.mark_reachable(program);
+    }
 
     TypeTable type_table;
     TypeChecker type_checker(log, type_table);
     type_checker.warns_as_errors = warns_as_errors;
-
-    if (!name_binder.run(program) || !type_checker.run(program))
-        return false;
+    {
+        Stats::Timer timer(stats, "check");
+        bool success = type_checker.run(program);
+        if (stats)
+            stats->add("types", type_table.type_count());
+        if (!success)
+            return false;
+    }
 
     thorin::Log::set(log_level, &std::cerr);
     Emitter emitter(log, world);
     emitter.warns_as_errors = warns_as_errors;
-    return emitter.run(program);
+    Stats::Timer timer(stats, "emit");
+    bool success = emitter.run(program);
+    if (stats)
+        stats->add("monomorphized functions", emitter.mono_fns.size());
+    return success;
 }
 
 } // namespace artic
@@ -1792,5 +1880,6 @@ bool compile(
     log::Output out(error_stream, false);
     Log log(out, &locator);
     ast::ModDecl program;
-    return artic::compile(file_names, file_data, false, false, program, world, log_level, log);
+    std::vector<std::string_view> file_views(file_data.begin(), file_data.end());
+    return artic::compile(file_names, file_views, false, false, false, program, world, log_level, log);
 }
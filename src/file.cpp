@@ -0,0 +1,65 @@
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "artic/file.h"
+
+namespace artic {
+
+std::optional<std::string> read_file(const std::string& file, bool binary) {
+    std::ifstream is(file, binary ? std::ios::in | std::ios::binary : std::ios::in);
+    if (!is)
+        return std::nullopt;
+    // Try/catch needed in case file is a directory (throws exception upon read)
+    try {
+        return std::make_optional(std::string(
+            std::istreambuf_iterator<char>(is),
+            std::istreambuf_iterator<char>()
+        ));
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapping_)
+        munmap(mapping_, size_);
+#endif
+}
+
+bool MappedFile::open(const std::string& file, bool binary) {
+#ifndef _WIN32
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || S_ISDIR(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    bool is_regular = S_ISREG(st.st_mode);
+    if (is_regular && st.st_size > 0) {
+        auto ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr != MAP_FAILED)
+            mapping_ = ptr, size_ = st.st_size;
+    }
+    close(fd);
+    if (mapping_ || (is_regular && st.st_size == 0))
+        return true;
+#endif
+    // Pipes, or systems without support for memory-mapped files
+    auto data = read_file(file, binary);
+    if (!data)
+        return false;
+    buffer_ = std::move(*data);
+    return true;
+}
+
+} // namespace artic
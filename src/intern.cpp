@@ -0,0 +1,71 @@
+#include <climits>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "artic/intern.h"
+#include "artic/hash.h"
+
+namespace artic {
+
+const Name::Entry Name::empty_entry = { std::string_view(), fnv::Offset<sizeof(size_t) * CHAR_BIT>::value(), 0 };
+
+// The table is split in shards to reduce contention when several threads intern names.
+static constexpr size_t shard_bits = 4;
+static constexpr size_t shard_count = size_t(1) << shard_bits;
+
+struct Shard {
+    struct Node {
+        std::string data;
+        Name::Entry entry;
+    };
+
+    struct Hash {
+        size_t operator () (const std::string_view& str) const { return fnv::Hash().combine(str); }
+    };
+
+    std::mutex mutex;
+    std::deque<Node> nodes;
+    std::unordered_map<std::string_view, const Name::Entry*, Hash> index;
+};
+
+static Shard* shards() {
+    static Shard shards[shard_count];
+    return shards;
+}
+
+Name::Name(std::string_view str) {
+    if (str.empty()) {
+        entry_ = &empty_entry;
+        return;
+    }
+
+    size_t hash = fnv::Hash().combine(str);
+    size_t shard_index = (hash >> (sizeof(size_t) * CHAR_BIT - shard_bits)) & (shard_count - 1);
+    auto& shard = shards()[shard_index];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (auto it = shard.index.find(str); it != shard.index.end()) {
+        entry_ = it->second;
+        return;
+    }
+
+    // Nodes in a deque never move, and neither do the entries and strings they contain
+    auto& node = shard.nodes.emplace_back();
+    node.data  = str;
+    node.entry = Entry { node.data, hash, uint32_t((shard.nodes.size() << shard_bits) | shard_index) };
+    shard.index.emplace(node.entry.str, &node.entry);
+    entry_ = &node.entry;
+}
+
+size_t Name::count() {
+    size_t count = 0;
+    for (size_t i = 0; i < shard_count; ++i) {
+        auto& shard = shards()[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.nodes.size();
+    }
+    return count;
+}
+
+} // namespace artic
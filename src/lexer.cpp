@@ -2,49 +2,219 @@
 #include <algorithm>
 #include <cctype>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARTIC_LEXER_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define ARTIC_LEXER_AVX2
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && (defined(ARTIC_LEXER_SSE2) || defined(ARTIC_LEXER_AVX2))
+#include <intrin.h>
+#endif
+
 #include "artic/lexer.h"
 
 namespace artic {
 
-std::unordered_map<std::string, Token::Tag> Lexer::keywords{
-    std::make_pair("let",       Token::Let),
-    std::make_pair("mut",       Token::Mut),
-    std::make_pair("as",        Token::As),
-    std::make_pair("fn",        Token::Fn),
-    std::make_pair("if",        Token::If),
-    std::make_pair("else",      Token::Else),
-    std::make_pair("match",     Token::Match),
-    std::make_pair("while",     Token::While),
-    std::make_pair("for",       Token::For),
-    std::make_pair("in",        Token::In),
-    std::make_pair("break",     Token::Break),
-    std::make_pair("continue",  Token::Continue),
-    std::make_pair("return",    Token::Return),
-    std::make_pair("struct",    Token::Struct),
-    std::make_pair("enum",      Token::Enum),
-    std::make_pair("type",      Token::Type),
-    std::make_pair("static",    Token::Static),
-    std::make_pair("mod",       Token::Mod),
-    std::make_pair("asm",       Token::Asm),
-    std::make_pair("addrspace", Token::AddrSpace),
-    std::make_pair("simd",      Token::Simd)
+// Character classes used to skip runs of ASCII characters in memory. Each class provides a
+// scalar test as well as SSE2 and AVX2 versions of it. Bytes that are not ASCII are never part
+// of a class, so that multibyte UTF-8 characters always go through the precise path of the lexer.
+namespace ascii {
+
+#ifdef ARTIC_LEXER_SSE2
+inline __m128i in_range(__m128i v, char lo, char hi) {
+    // Bytes above 0x7F are negative, and thus never in the range
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+inline __m128i equals(__m128i v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+inline __m128i is_ascii(__m128i v) { return _mm_cmpgt_epi8(v, _mm_set1_epi8(-1)); }
+inline __m128i lower(__m128i v) { return _mm_or_si128(v, _mm_set1_epi8(0x20)); }
+inline __m128i either(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+inline __m128i and_not(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+#endif
+
+#ifdef ARTIC_LEXER_AVX2
+inline __m256i in_range(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+}
+inline __m256i equals(__m256i v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+inline __m256i is_ascii(__m256i v) { return _mm256_cmpgt_epi8(v, _mm256_set1_epi8(-1)); }
+inline __m256i lower(__m256i v) { return _mm256_or_si256(v, _mm256_set1_epi8(0x20)); }
+inline __m256i either(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+inline __m256i and_not(__m256i a, __m256i b) { return _mm256_andnot_si256(b, a); }
+#endif
+
+/// White space, as defined by `std::isspace()` in the "C" locale.
+struct Space {
+    static bool test(uint8_t c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+    template <typename V> static V test(V v) { return either(equals(v, ' '), in_range(v, '\t', '\r')); }
+};
+
+/// Characters that can appear in an identifier, after the first one.
+struct Ident {
+    static bool test(uint8_t c) { return std::isalnum(c) || c == '_'; }
+    template <typename V> static V test(V v) { return either(either(in_range(lower(v), 'a', 'z'), in_range(v, '0', '9')), equals(v, '_')); }
+};
+
+/// Decimal digits.
+struct Digit {
+    static bool test(uint8_t c) { return c >= '0' && c <= '9'; }
+    template <typename V> static V test(V v) { return in_range(v, '0', '9'); }
+};
+
+/// Hexadecimal digits.
+struct HexDigit {
+    static bool test(uint8_t c) { return std::isxdigit(c); }
+    template <typename V> static V test(V v) { return either(in_range(lower(v), 'a', 'f'), in_range(v, '0', '9')); }
 };
 
-Lexer::Lexer(Log& log, const std::string& filename, std::istream& is)
+/// Contents of a single-line comment.
+struct LineComment {
+    static bool test(uint8_t c) { return c != '\n' && c < 0x80; }
+    template <typename V> static V test(V v) { return and_not(is_ascii(v), equals(v, '\n')); }
+};
+
+/// Contents of a multi-line comment, up to the next star.
+struct BlockComment {
+    static bool test(uint8_t c) { return c != '*' && c < 0x80; }
+    template <typename V> static V test(V v) { return and_not(is_ascii(v), equals(v, '*')); }
+};
+
+#if defined(ARTIC_LEXER_SSE2) || defined(ARTIC_LEXER_AVX2)
+inline size_t count_trailing_zeros(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/// Returns a pointer to the first byte in the given range that does not belong to the given class.
+template <typename Class>
+const char* scan(const char* ptr, const char* end) {
+#ifdef ARTIC_LEXER_AVX2
+    for (; end - ptr >= 32; ptr += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        uint32_t mask = ~uint32_t(_mm256_movemask_epi8(Class::test(v)));
+        if (mask != 0)
+            return ptr + count_trailing_zeros(mask);
+    }
+#endif
+#ifdef ARTIC_LEXER_SSE2
+    for (; end - ptr >= 16; ptr += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        uint32_t mask = ~uint32_t(_mm_movemask_epi8(Class::test(v))) & 0xFFFF;
+        if (mask != 0)
+            return ptr + count_trailing_zeros(mask);
+    }
+#endif
+    while (ptr != end && Class::test(uint8_t(*ptr))) ptr++;
+    return ptr;
+}
+
+} // namespace ascii
+
+// Keywords are recognized with a perfect hash table, computed at compile-time from the list of tokens.
+namespace keywords {
+
+struct Entry {
+    std::string_view name;
+    Token::Tag tag = Token::Error;
+};
+
+constexpr Entry tokens[] = {
+#define TAG(t, str) { str, Token::t },
+    TOKEN_TAGS(TAG)
+#undef TAG
+};
+
+constexpr bool is_keyword(std::string_view name) {
+    return name[0] >= 'a' && name[0] <= 'z';
+}
+
+struct Table {
+    static constexpr size_t bits = 6;
+    static constexpr size_t size = size_t(1) << bits;
+    static constexpr uint32_t max_seed = 1 << 12;
+
+    Entry entries[size] = {};
+    uint32_t seed = 0;
+
+    // Keywords are uniquely identified by their length, first, and last characters
+    static constexpr size_t slot(uint32_t seed, std::string_view name) {
+        uint32_t h = uint32_t(name.size()) | uint32_t(uint8_t(name.front())) << 8 | uint32_t(uint8_t(name.back())) << 16;
+        h = (h ^ seed) * 0x9E3779B1u;
+        h = (h ^ (h >> 15)) * 0x85EBCA77u;
+        return h >> (32 - bits);
+    }
+
+    constexpr Table() {
+        for (; seed < max_seed; ++seed) {
+            bool used[size] = {};
+            bool collision = false;
+            for (auto& token : tokens) {
+                if (!is_keyword(token.name))
+                    continue;
+                auto i = slot(seed, token.name);
+                collision |= used[i];
+                used[i] = true;
+            }
+            if (!collision)
+                break;
+        }
+        for (auto& token : tokens) {
+            if (is_keyword(token.name))
+                entries[slot(seed, token.name)] = token;
+        }
+    }
+};
+
+constexpr Table table;
+static_assert(table.seed < Table::max_seed, "cannot find a perfect hash function for keywords");
+
+} // namespace keywords
+
+std::optional<Token::Tag> Lexer::find_keyword(std::string_view name) {
+    if (name.empty())
+        return std::nullopt;
+    auto& entry = keywords::table.entries[keywords::Table::slot(keywords::table.seed, name)];
+    if (entry.name != name)
+        return std::nullopt;
+    return std::make_optional(entry.tag);
+}
+
+Lexer::Lexer(Log& log, uint32_t file, std::istream& is)
     : Logger(log)
-    , stream_(is)
-    , loc_(std::make_shared<std::string>(filename), 1, 0)
+    , stream_(&is)
+    , loc_(file, 1, 0)
 {
     // Read UTF-8 byte order mark (if any)
     uint8_t bytes[] = { 0, 0, 0 };
-    stream_.read((char*)bytes, 3);
+    stream_->read((char*)bytes, 3);
     if (!utf8::is_bom(bytes)) {
-        stream_.clear();
-        stream_.seekg(0);
+        stream_->clear();
+        stream_->seekg(0);
     }
     eat();
 }
 
+Lexer::Lexer(Log& log, uint32_t file, std::string_view data)
+    : Logger(log)
+    , ptr_(data.data())
+    , end_(data.data() + data.size())
+    , loc_(file, 1, 0)
+{
+    // Skip UTF-8 byte order mark (if any)
+    if (data.size() >= 3 && utf8::is_bom(reinterpret_cast<const uint8_t*>(ptr_)))
+        ptr_ += 3;
+    eat();
+}
+
 Token Lexer::next() {
     while (true) {
         eat_spaces();
@@ -52,102 +222,102 @@ Token Lexer::next() {
         str_.clear();
         loc_.begin = loc_.end;
 
-        if (eof()) return Token(loc_, Token::End);
+        if (eof()) return Token(Token::End, loc_);
 
-        if (accept('(')) return Token(loc_, Token::LParen);
-        if (accept(')')) return Token(loc_, Token::RParen);
-        if (accept('{')) return Token(loc_, Token::LBrace);
-        if (accept('}')) return Token(loc_, Token::RBrace);
-        if (accept('[')) return Token(loc_, Token::LBracket);
-        if (accept(']')) return Token(loc_, Token::RBracket);
+        if (accept('(')) return Token(Token::LParen, loc_);
+        if (accept(')')) return Token(Token::RParen, loc_);
+        if (accept('{')) return Token(Token::LBrace, loc_);
+        if (accept('}')) return Token(Token::RBrace, loc_);
+        if (accept('[')) return Token(Token::LBracket, loc_);
+        if (accept(']')) return Token(Token::RBracket, loc_);
         if (accept('.')) {
             if (accept('.')) {
-                if (accept('.')) return Token(loc_, Token::Dots);
+                if (accept('.')) return Token(Token::Dots, loc_);
                 error(loc_, "unknown token '..'");
-                return Token(loc_);
+                return Token(Token::Error, loc_);
             }
-            return Token(loc_, Token::Dot);
+            return Token(Token::Dot, loc_);
         }
-        if (accept(',')) return Token(loc_, Token::Comma);
-        if (accept(';')) return Token(loc_, Token::Semi);
+        if (accept(',')) return Token(Token::Comma, loc_);
+        if (accept(';')) return Token(Token::Semi, loc_);
         if (accept(':')) {
-            if (accept(':')) return Token(loc_, Token::DblColon);
-            return Token(loc_, Token::Colon);
+            if (accept(':')) return Token(Token::DblColon, loc_);
+            return Token(Token::Colon, loc_);
         }
         if (accept('=')) {
-            if (accept('=')) return Token(loc_, Token::CmpEq);
-            if (accept('>')) return Token(loc_, Token::FatArrow);
-            return Token(loc_, Token::Eq);
+            if (accept('=')) return Token(Token::CmpEq, loc_);
+            if (accept('>')) return Token(Token::FatArrow, loc_);
+            return Token(Token::Eq, loc_);
         }
         if (accept('<')) {
             if (accept('<')) {
-                if (accept('=')) return Token(loc_, Token::LShftEq);
-                return Token(loc_, Token::LShft);
+                if (accept('=')) return Token(Token::LShftEq, loc_);
+                return Token(Token::LShft, loc_);
             }
-            if (accept('=')) return Token(loc_, Token::CmpLE);
-            return Token(loc_, Token::CmpLT);
+            if (accept('=')) return Token(Token::CmpLE, loc_);
+            return Token(Token::CmpLT, loc_);
         }
         if (accept('>')) {
             if (accept('>')) {
-                if (accept('=')) return Token(loc_, Token::RShftEq);
-                return Token(loc_, Token::RShft);
+                if (accept('=')) return Token(Token::RShftEq, loc_);
+                return Token(Token::RShft, loc_);
             }
-            if (accept('=')) return Token(loc_, Token::CmpGE);
-            return Token(loc_, Token::CmpGT);
+            if (accept('=')) return Token(Token::CmpGE, loc_);
+            return Token(Token::CmpGT, loc_);
         }
         if (accept('+')) {
-            if (accept('+')) return Token(loc_, Token::Inc);
-            if (accept('=')) return Token(loc_, Token::AddEq);
-            return Token(loc_, Token::Add);
+            if (accept('+')) return Token(Token::Inc, loc_);
+            if (accept('=')) return Token(Token::AddEq, loc_);
+            return Token(Token::Add, loc_);
         }
         if (accept('-')) {
-            if (accept('>')) return Token(loc_, Token::Arrow);
-            if (accept('-')) return Token(loc_, Token::Dec);
-            if (accept('=')) return Token(loc_, Token::SubEq);
-            return Token(loc_, Token::Sub);
+            if (accept('>')) return Token(Token::Arrow, loc_);
+            if (accept('-')) return Token(Token::Dec, loc_);
+            if (accept('=')) return Token(Token::SubEq, loc_);
+            return Token(Token::Sub, loc_);
         }
         if (accept('*')) {
-            if (accept('=')) return Token(loc_, Token::MulEq);
-            return Token(loc_, Token::Mul);
+            if (accept('=')) return Token(Token::MulEq, loc_);
+            return Token(Token::Mul, loc_);
         }
         if (accept('/')) {
             // Handle comments here
             if (accept('*')) { eat_comments(); continue; }
             if (accept('/')) {
-                while (!eof() && peek() != '\n') eat();
+                eat_line_comment();
                 continue;
             }
-            if (accept('=')) return Token(loc_, Token::DivEq);
-            return Token(loc_, Token::Div);
+            if (accept('=')) return Token(Token::DivEq, loc_);
+            return Token(Token::Div, loc_);
         }
         if (accept('%')) {
-            if (accept('=')) return Token(loc_, Token::RemEq);
-            return Token(loc_, Token::Rem);
+            if (accept('=')) return Token(Token::RemEq, loc_);
+            return Token(Token::Rem, loc_);
         }
         if (accept('&')) {
-            if (accept('&')) return Token(loc_, Token::LogicAnd);
-            if (accept('=')) return Token(loc_, Token::AndEq);
-            return Token(loc_, Token::And);
+            if (accept('&')) return Token(Token::LogicAnd, loc_);
+            if (accept('=')) return Token(Token::AndEq, loc_);
+            return Token(Token::And, loc_);
         }
         if (accept('|')) {
-            if (accept('|')) return Token(loc_, Token::LogicOr);
-            if (accept('=')) return Token(loc_, Token::OrEq);
-            return Token(loc_, Token::Or);
+            if (accept('|')) return Token(Token::LogicOr, loc_);
+            if (accept('=')) return Token(Token::OrEq, loc_);
+            return Token(Token::Or, loc_);
         }
         if (accept('^')) {
-            if (accept('=')) return Token(loc_, Token::XorEq);
-            return Token(loc_, Token::Xor);
+            if (accept('=')) return Token(Token::XorEq, loc_);
+            return Token(Token::Xor, loc_);
         }
 
         if (accept('!')) {
-            if (accept('=')) return Token(loc_, Token::CmpNE);
-            return Token(loc_, Token::Not);
+            if (accept('=')) return Token(Token::CmpNE, loc_);
+            return Token(Token::Not, loc_);
         }
 
-        if (accept('#')) return Token(loc_, Token::Hash);
-        if (accept('@')) return Token(loc_, Token::At);
-        if (accept('?')) return Token(loc_, Token::QMark);
-        if (accept('$')) return Token(loc_, Token::Dollar);
+        if (accept('#')) return Token(Token::Hash, loc_);
+        if (accept('@')) return Token(Token::At, loc_);
+        if (accept('?')) return Token(Token::QMark, loc_);
+        if (accept('$')) return Token(Token::Dollar, loc_);
         if (accept('\'')) {
             if (!eof()) {
                 bool is_nl = peek() == '\n';
@@ -159,11 +329,11 @@ Token Lexer::next() {
                     }
                     if (is_nl)
                         error(loc_, "multiline character literals are not allowed");
-                    return Token(loc_, str_, Literal(uint8_t(str_[1])));
+                    return literal(loc_, Literal(uint8_t(str_[1])));
                 }
             }
             error(loc_.at_begin().enlarge_after(), "unterminated character literal");
-            return Token(loc_);
+            return Token(Token::Error, loc_);
         }
         if (accept('\"')) {
             Loc str_loc;
@@ -174,7 +344,7 @@ Token Lexer::next() {
                     append_char();
                 if (eof() || !accept('\"')) {
                     error(loc_.at_begin().enlarge_after(), "unterminated string literal");
-                    return Token(loc_);
+                    return Token(Token::Error, loc_);
                 }
                 str_loc = loc_;
                 str_lit += str_.substr(pos, str_.size() - (pos + 1));
@@ -183,32 +353,47 @@ Token Lexer::next() {
                     break;
             }
             assert(str_.size() >= 2);
-            return Token(str_loc, str_, str_lit);
+            return literal(str_loc, Literal(str_lit));
         }
 
         if (std::isdigit(peek()) || peek() == '.') {
             auto lit = parse_literal();
-            return Token(loc_, str_, lit);
+            return literal(loc_, lit);
         }
 
         if (std::isalpha(peek()) || peek() == '_') {
-            append();
-            while (std::isalnum(peek()) || peek() == '_') append();
+            if (in_memory())
+                append<ascii::Ident>();
+            else {
+                append();
+                while (std::isalnum(peek()) || peek() == '_') append();
+            }
 
-            if (str_ == "true")  return Token(loc_, str_, true);
-            if (str_ == "false") return Token(loc_, str_, false);
+            if (str_ == "true")  return literal(loc_, Literal(true));
+            if (str_ == "false") return literal(loc_, Literal(false));
 
-            auto key_it = keywords.find(str_);
-            if (key_it == keywords.end()) return Token(loc_, str_);
-            return Token(loc_, key_it->second);
+            if (auto tag = find_keyword(str_)) return Token(*tag, loc_);
+            identifiers_.emplace_back(str_);
+            return Token(Token::Id, loc_, uint32_t(identifiers_.size() - 1));
         }
 
         append();
         error(loc_, "unknown token '{}'", str_);
-        return Token(loc_);
+        return Token(Token::Error, loc_);
     }
 }
 
+Token Lexer::literal(const Loc& loc, const Literal& lit) {
+    literals_.emplace_back(lit, str_);
+    return Token(Token::Lit, loc, uint32_t(literals_.size() - 1));
+}
+
+std::string Lexer::string(const Token& token) const {
+    if (token.is_identifier()) return std::string(identifier(token).str());
+    if (token.is_literal())    return literals_[token.index()].second;
+    return Token::tag_to_string(token.tag());
+}
+
 void Lexer::eat() {
     if (cur_.bytes[0] == '\n') {
         loc_.end.row++;
@@ -216,39 +401,110 @@ void Lexer::eat() {
     } else {
         loc_.end.col++;
     }
+    read();
+}
+
+void Lexer::read() {
+    if (stream_) {
+        cur_.bytes[0] = stream_->get();
+        cur_.size = eof() ? 0 : 1;
+    } else if (ptr_ != end_) {
+        cur_.bytes[0] = *(ptr_++);
+        cur_.size = 1;
+    } else {
+        cur_.bytes[0] = uint8_t(std::char_traits<char>::eof());
+        cur_.size = 0;
+        eof_ = true;
+    }
+    if (cur_.size > 0 && utf8::is_begin(cur_.bytes[0]))
+        eat_multibyte();
+}
 
-    cur_.bytes[0] = stream_.get();
-    cur_.size = eof() ? 0 : 1;
-    if (cur_.size > 0 && utf8::is_begin(cur_.bytes[0])) {
-        bool ok = true;
-        cur_.size = utf8::count_bytes(cur_.bytes[0]);
-        if (eof() || cur_.size < utf8::min_bytes() || cur_.size > utf8::max_bytes()) {
+void Lexer::eat_multibyte() {
+    bool ok = true;
+    cur_.size = utf8::count_bytes(cur_.bytes[0]);
+    if (eof() || cur_.size < utf8::min_bytes() || cur_.size > utf8::max_bytes()) {
+        ok = false;
+        cur_.size = 1;
+    }
+    size_t read = 0;
+    for (size_t i = 1; ok && i < cur_.size; ++i) {
+        auto c = std::char_traits<char>::eof();
+        if (stream_)
+            c = stream_->get();
+        else if (ptr_ + read != end_)
+            c = uint8_t(ptr_[read]);
+        if (c == std::char_traits<char>::eof()) {
             ok = false;
-            cur_.size = 1;
+            break;
         }
-        size_t read = 0;
-        for (size_t i = 1; i < cur_.size; ++i, ++read) {
-            uint8_t c = stream_.get();
-            ok &= !eof() && utf8::is_valid(c);
-            if (!ok)
-                break;
-            cur_.bytes[i] = c;
+        read++;
+        ok = utf8::is_valid(c);
+        cur_.bytes[i] = c;
+    }
+    if (!ok) {
+        cur_.size = 1;
+        if (stream_) {
+            // Rollback read chars
+            stream_->clear();
+            stream_->seekg(-std::streamoff(read), std::istream::cur);
         }
-        if (!ok) {
-            cur_.size = 1;
-            stream_.seekg(-std::streamoff(read), std::istream::cur); // Rollback read chars.
-            error(Loc(loc_.file, loc_.end.row, loc_.end.col, loc_.end.row, loc_.end.col + 1), "invalid UTF-8 character");
+        error(Loc(loc_.file, loc_.end.row, loc_.end.col, loc_.end.row, loc_.end.col + 1), "invalid UTF-8 character");
+    } else if (!stream_)
+        ptr_ += read;
+}
+
+template <typename Class>
+const char* Lexer::skip() {
+    assert(in_memory() && Class::test(peek()));
+    auto first = ptr_ - 1;
+    auto last  = ascii::scan<Class>(ptr_, end_);
+    for (auto ptr = first; ptr != last; ++ptr) {
+        if (*ptr == '\n') {
+            loc_.end.row++;
+            loc_.end.col = 1;
+        } else {
+            loc_.end.col++;
         }
     }
+    ptr_ = last;
+    read();
+    return last;
+}
+
+template <typename Class>
+void Lexer::append() {
+    auto first = ptr_ - 1;
+    auto last  = skip<Class>();
+    str_.append(first, last);
 }
 
 void Lexer::eat_spaces() {
-    while (!eof() && std::isspace(peek())) eat();
+    while (!eof() && std::isspace(peek())) {
+        if (in_memory())
+            skip<ascii::Space>();
+        else
+            eat();
+    }
+}
+
+void Lexer::eat_line_comment() {
+    while (!eof() && peek() != '\n') {
+        if (in_memory() && ascii::LineComment::test(peek()))
+            skip<ascii::LineComment>();
+        else
+            eat();
+    }
 }
 
 void Lexer::eat_comments() {
     while (true) {
-        while (!eof() && peek() != '*') eat();
+        while (!eof() && peek() != '*') {
+            if (in_memory() && ascii::BlockComment::test(peek()))
+                skip<ascii::BlockComment>();
+            else
+                eat();
+        }
         if (eof()) {
             error(loc_, "non-terminated multiline comment");
             return;
@@ -262,6 +518,12 @@ Literal Lexer::parse_literal() {
     int base = 10;
 
     auto parse_digits = [&] {
+        if (in_memory()) {
+            if (base == 16 && ascii::HexDigit::test(peek()))
+                append<ascii::HexDigit>();
+            else if (base != 16 && ascii::Digit::test(peek()))
+                append<ascii::Digit>();
+        }
         while (std::isdigit(peek()) ||
                (base == 16 && peek() >= 'a' && peek() <= 'f') ||
                (base == 16 && peek() >= 'A' && peek() <= 'F')) {
@@ -23,6 +23,17 @@ void Log::print_summary() {
     }
 }
 
+void Log::append(std::string_view messages, size_t errors, size_t warns) {
+    if (!messages.empty() && !is_full()) {
+        // Messages are separated by an empty line (see `Logger::error()` and `Logger::warn()`)
+        if (this->errors > 0 || this->warns > 0)
+            out.stream << "\n";
+        out.stream << messages;
+    }
+    this->errors += errors;
+    this->warns  += warns;
+}
+
 inline size_t count_digits(size_t i) {
     size_t n = 0;
     while (i > 0) i /= 10, n++;
@@ -30,15 +41,23 @@ inline size_t count_digits(size_t i) {
 }
 
 void Logger::diagnostic(const Loc& loc, log::Style style, char underline) {
-    log::format(log.out, " in {}\n", log::style(loc, log::Style::White, log::Style::Bold));
+    log::format(log.out, " in {}{}\n",
+        log::style(log.locator ? log.locator->file_name(loc.file) : "<unknown>", log::Style::White, log::Style::Bold),
+        log::style(loc, log::Style::White, log::Style::Bold));
     if (!diagnostics || !log.locator)
         return;
 
-    auto loc_info = log.locator->data(*loc.file);
+    auto loc_info = log.locator->data(loc.file);
     if (!loc_info || !loc_info->covers(loc))
         return;
 
     auto indent = 1 + count_digits(loc.end.row);
+    auto tab_width = log.locator->tab_width;
+    auto source = [&] (const char* begin, const char* end) {
+        return log::expand_tabs(std::string_view(begin, end - begin), tab_width);
+    };
+    auto begin_width = loc_info->width(loc.begin.row, loc.begin.col, tab_width);
+    auto end_width   = loc_info->width(loc.end.row, loc.end.col, tab_width);
 
     auto begin_line     = loc_info->at(loc.begin.row, 1);
     auto begin_line_loc = loc_info->at(loc.begin.row, loc.begin.col);
@@ -53,35 +72,36 @@ void Logger::diagnostic(const Loc& loc, log::Style style, char underline) {
         log::fill(' ', indent - count_digits(loc.begin.row)),
         log::style(loc.begin.row, log::Style::White, log::Style::Bold),
         log::style('|', style, log::Style::Bold),
-        std::string_view(begin_line, begin_line_loc - begin_line)
+        source(begin_line, begin_line_loc)
     );
     bool multiline = loc.begin.row != loc.end.row;
     if (multiline) {
+        auto line_width = loc_info->width(loc.begin.row, loc_info->line_size(loc.begin.row) + 1, tab_width);
         log::format(log.out, "{}\n{} {}{}{}\n{}{}\n{}{} {}{}{}\n{} {}{}\n",
-            log::style(std::string_view(begin_line_loc, begin_line_end - begin_line_loc), style, log::Style::Bold),
+            log::style(source(begin_line_loc, begin_line_end), style, log::Style::Bold),
             log::fill(' ', indent),
             log::style('|', style, log::Style::Bold),
-            log::fill(' ', loc.begin.col - 1),
-            log::style(log::fill(underline, loc_info->line_size(loc.begin.row) + 1 - loc.begin.col), style, log::Style::Bold),
+            log::fill(' ', begin_width),
+            log::style(log::fill(underline, line_width - begin_width), style, log::Style::Bold),
             log::fill(' ', indent > 3 ? indent - 3 : 0),
             log::style("...", log::Style::White, log::Style::Bold),
             log::fill(' ', indent - count_digits(loc.end.row)),
             log::style(loc.end.row, log::Style::White, log::Style::Bold),
             log::style('|', style, log::Style::Bold),
-            log::style(std::string_view(end_line, end_line_loc - end_line), style, log::Style::Bold),
-            std::string_view(end_line_loc, end_line_end - end_line_loc),
+            log::style(source(end_line, end_line_loc), style, log::Style::Bold),
+            source(end_line_loc, end_line_end),
             log::fill(' ', indent),
             log::style('|', style, log::Style::Bold),
-            log::style(log::fill(underline, loc.end.col - 1), style, log::Style::Bold)
+            log::style(log::fill(underline, end_width), style, log::Style::Bold)
         );
     } else {
         log::format(log.out, "{}{}\n{} {}{}{}\n",
-            log::style(std::string_view(begin_line_loc, end_line_loc - begin_line_loc), style, log::Style::Bold),
-            std::string_view(end_line_loc, end_line_end - end_line_loc),
+            log::style(source(begin_line_loc, end_line_loc), style, log::Style::Bold),
+            source(end_line_loc, end_line_end),
             log::fill(' ', indent),
             log::style('|', style, log::Style::Bold),
-            log::fill(' ', loc.begin.col - 1),
-            log::style(log::fill(underline, loc.end.col - loc.begin.col), style, log::Style::Bold)
+            log::fill(' ', begin_width),
+            log::style(log::fill(underline, end_width - begin_width), style, log::Style::Bold)
         );
     }
 }
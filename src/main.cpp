@@ -1,5 +1,6 @@
 #include <vector>
 #include <string>
+#include <memory>
 #include <streambuf>
 #include <istream>
 #include <fstream>
@@ -8,6 +9,9 @@
 #include "artic/print.h"
 #include "artic/emit.h"
 #include "artic/locator.h"
+#include "artic/stats.h"
+#include "artic/cache.h"
+#include "artic/file.h"
 
 #include <thorin/world.h>
 #include <thorin/be/c.h>
@@ -43,6 +47,14 @@ static void usage() {
                 "         --emit-c-interface     Emits C interface for exported functions and imported types\n"
                 "         --log-level <lvl>      Changes the log level in Thorin (lvl = debug, verbose, info, warn, or error, defaults to error)\n"
                 "         --tab-width <n>        Sets the width of the TAB character in error messages or when printing the AST (in spaces, defaults to 2)\n"
+                "         --no-teardown          Does not free the AST before exiting\n"
+                "         --reachable-only       Only checks and emits the declarations used by exported functions or mutable statics\n"
+                "         --cache                Caches the AST of parsed files in $XDG_CACHE_HOME/artic (or $HOME/.cache/artic)\n"
+                "         --cache-dir <dir>      Caches the AST of parsed files in the given directory\n"
+                "         --round-trip-ast       Serializes the AST of parsed files and reads it back (for testing)\n"
+                "         --time-passes          Displays the time spent in each compilation pass\n"
+                "         --stats                Displays the number of tokens, AST nodes, types, and IR definitions\n"
+                "         --stats-format <fmt>   Sets the format of timings and statistics (fmt = text or json, defaults to text)\n"
 #ifdef ENABLE_LLVM
                 "         --emit-llvm            Emits LLVM IR in the output file\n"
                 "  -g     --debug                Enable debug information in the generated LLVM IR file\n"
@@ -92,6 +104,13 @@ struct ProgramOptions {
     bool emit_c_int = false;
     bool emit_llvm = false;
     bool show_implicit_casts = false;
+    bool no_teardown = false;
+    bool reachable_only = false;
+    std::string cache_dir;
+    bool round_trip_ast = false;
+    bool time_passes = false;
+    bool stats = false;
+    bool stats_json = false;
     unsigned opt_level = 0;
     size_t max_errors = 0;
     size_t tab_width = 2;
@@ -149,6 +168,39 @@ struct ProgramOptions {
                     print_ast = true;
                 } else if (matches(argv[i], "--show-implicit-casts")) {
                     show_implicit_casts = true;
+                } else if (matches(argv[i], "--no-teardown")) {
+                    no_teardown = true;
+                } else if (matches(argv[i], "--reachable-only")) {
+                    reachable_only = true;
+                } else if (matches(argv[i], "--cache")) {
+                    cache_dir = Cache::default_dir();
+                    if (cache_dir.empty()) {
+                        log::error("cannot find a cache directory, use '--cache-dir' instead");
+                        return false;
+                    }
+                } else if (matches(argv[i], "--cache-dir")) {
+                    if (!check_arg(argc, argv, i))
+                        return false;
+                    cache_dir = argv[++i];
+                } else if (matches(argv[i], "--round-trip-ast")) {
+                    round_trip_ast = true;
+                } else if (matches(argv[i], "--time-passes")) {
+                    time_passes = true;
+                } else if (matches(argv[i], "--stats")) {
+                    stats = true;
+                } else if (matches(argv[i], "--stats-format")) {
+                    if (!check_arg(argc, argv, i))
+                        return false;
+                    i++;
+                    using namespace std::string_literals;
+                    if (argv[i] == "text"s)
+                        stats_json = false;
+                    else if (argv[i] == "json"s)
+                        stats_json = true;
+                    else {
+                        log::error("unknown statistics format '{}'", argv[i]);
+                        return false;
+                    }
                 } else if (matches(argv[i], "--emit-thorin")) {
                     emit_thorin = true;
                 } else if (matches(argv[i], "--emit-c-interface")) {
@@ -207,33 +259,6 @@ struct ProgramOptions {
     }
 };
 
-static std::optional<std::string> read_file(const std::string& file) {
-    std::ifstream is(file);
-    if (!is)
-        return std::nullopt;
-    // Try/catch needed in case file is a directory (throws exception upon read)
-    try {
-        return std::make_optional(std::string(
-            std::istreambuf_iterator<char>(is),
-            std::istreambuf_iterator<char>()
-        ));
-    } catch (...) {
-        return std::nullopt;
-    }
-}
-
-static std::string tabs_to_spaces(const std::string& str, size_t indent) {
-    std::string res;
-    res.reserve(str.size());
-    for (auto c : str) {
-        size_t n = 1;
-        if (c == '\t')
-            n = indent, c = ' ';
-        res.append(n, c);
-    }
-    return res;
-}
-
 int main(int argc, char** argv) {
     ProgramOptions opts;
     if (!opts.parse(argc, argv))
@@ -253,31 +278,52 @@ int main(int argc, char** argv) {
         opts.module_name = file_without_ext(opts.files.front());
 
     Locator locator;
+    locator.tab_width = opts.tab_width;
     Log log(log::err, &locator);
     log.max_errors = opts.max_errors;
 
-    std::vector<std::string> file_data;
-    for (auto& file : opts.files) {
-        // Tabs to spaces conversion is necessary in order to provide good error diagnostics.
-        auto data = read_file(file);
-        if (!data) {
-            log::error("cannot open file '{}'", file);
+    std::vector<MappedFile> inputs(opts.files.size());
+    std::vector<std::string_view> file_data;
+    for (size_t i = 0, n = opts.files.size(); i < n; ++i) {
+        if (!inputs[i].open(opts.files[i])) {
+            log::error("cannot open file '{}'", opts.files[i]);
             return EXIT_FAILURE;
         }
-        file_data.emplace_back(tabs_to_spaces(*data, opts.tab_width));
+        file_data.emplace_back(inputs[i].data());
     }
 
+    Stats stats;
+    stats.time_passes = opts.time_passes;
+    stats.count = opts.stats;
+    auto print_stats = [&] {
+        if (!opts.time_passes && !opts.stats)
+            return;
+        if (opts.stats_json)
+            stats.print_json(log::out.stream);
+        else
+            stats.print(log::out);
+    };
+
+    Cache cache(opts.cache_dir);
     thorin::World world(opts.module_name);
-    ast::ModDecl program;
+    auto program_ptr = std::make_unique<ast::ModDecl>();
+    auto& program = *program_ptr;
+    // The memory of the AST is reclaimed by the system when the process exits
+    if (opts.no_teardown)
+        (void)program_ptr.release();
     bool success = compile(
         opts.files,
         file_data,
         opts.warns_as_errors,
         opts.enable_all_warns,
+        opts.reachable_only,
         program,
         world,
         opts.log_level,
-        log);
+        log,
+        &stats,
+        opts.cache_dir.empty() ? nullptr : &cache,
+        opts.round_trip_ast);
 
     log.print_summary();
 
@@ -291,11 +337,16 @@ int main(int argc, char** argv) {
         log::out << "\n";
     }
 
-    if (!success)
+    if (!success) {
+        print_stats();
         return EXIT_FAILURE;
+    }
+    stats.add("thorin defs", world.defs().size());
 
-    if (opts.opt_level == 1)
+    if (opts.opt_level == 1) {
+        Stats::Timer timer(&stats, "cleanup");
         world.cleanup();
+    }
     if (opts.emit_c_int) {
         auto name = opts.module_name + ".h";
         std::ofstream file(name);
@@ -304,8 +355,10 @@ int main(int argc, char** argv) {
         else
             thorin::emit_c_int(world, file);
     }
-    if (opts.opt_level > 1 || opts.emit_llvm)
+    if (opts.opt_level > 1 || opts.emit_llvm) {
+        Stats::Timer timer(&stats, "opt");
         world.opt();
+    }
     if (opts.emit_thorin)
         world.dump();
 #ifdef ENABLE_LLVM
@@ -317,8 +370,10 @@ int main(int argc, char** argv) {
                 std::ofstream file(name);
                 if (!file)
                     log::error("cannot open '{}' for writing", name);
-                else
+                else {
+                    Stats::Timer timer(&stats, "codegen " + ext.substr(1));
                     cg->emit(file, opts.opt_level, opts.debug);
+                }
             }
         };
         emit_to_file(backends.cpu_cg.get(),    ".ll");
@@ -329,5 +384,6 @@ int main(int argc, char** argv) {
         emit_to_file(backends.hls_cg.get(),    ".hls");
     }
 #endif
+    print_stats();
     return EXIT_SUCCESS;
 }
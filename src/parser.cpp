@@ -78,7 +78,7 @@ Ptr<ast::FnDecl> Parser::parse_fn_decl() {
     if (ahead().tag() == Token::LParen)
         param = parse_tuple_ptrn(true);
     else
-        error(ahead().loc(), "parameter list expected in function definition");
+        error(lexer_.loc(ahead()), "parameter list expected in function definition");
 
     Ptr<ast::Type> ret_type;
     if (accept(Token::Arrow))
@@ -94,7 +94,7 @@ Ptr<ast::FnDecl> Parser::parse_fn_decl() {
 
     if (!body) {
         if (!ret_type)
-            error(ahead().loc(), "return type expected for function prototype");
+            error(lexer_.loc(ahead()), "return type expected for function prototype");
         expect(Token::Semi);
     }
 
@@ -104,7 +104,7 @@ Ptr<ast::FnDecl> Parser::parse_fn_decl() {
 
 Ptr<ast::FieldDecl> Parser::parse_field_decl(bool is_tuple_like) {
     Tracker tracker(this);
-    auto id = is_tuple_like ? ast::Identifier(tracker(), "") : parse_id();
+    auto id = is_tuple_like ? ast::Identifier(tracker(), Name()) : parse_id();
     if (!is_tuple_like)
         expect(Token::Colon);
     auto type = parse_type();
@@ -239,7 +239,7 @@ Ptr<ast::ModDecl> Parser::parse_mod_decl() {
 
 Ptr<ast::ErrorDecl> Parser::parse_error_decl() {
     Tracker tracker(this);
-    error(ahead().loc(), "expected declaration, got '{}'", ahead().string());
+    error(lexer_.loc(ahead()), "expected declaration, got '{}'", lexer_.string(ahead()));
     next();
     return make_ptr<ast::ErrorDecl>(tracker());
 }
@@ -251,7 +251,7 @@ Ptr<ast::Ptrn> Parser::parse_ptrn(bool is_fn_param) {
     switch (ahead().tag()) {
         case Token::Id:
             {
-                if (auto tag = ast::PrimType::tag_from_token(ahead()); tag != ast::PrimType::Error) {
+                if (auto tag = ast::PrimType::tag_from_name(lexer_.identifier(ahead())); tag != ast::PrimType::Error) {
                     if (!is_fn_param)
                         return parse_error_ptrn();
                     auto type = parse_prim_type(tag);
@@ -333,8 +333,8 @@ Ptr<ast::FieldPtrn> Parser::parse_field_ptrn() {
     ast::Identifier id;
     Ptr<ast::Ptrn> ptrn;
     if (ahead().tag() == Token::Dots) {
-        id.name = "...";
-        id.loc = ahead().loc();
+        id.name = Name("...");
+        id.loc = lexer_.loc(ahead());
         eat(Token::Dots);
     } else {
         id = parse_id();
@@ -393,7 +393,7 @@ Ptr<ast::ArrayPtrn> Parser::parse_array_ptrn() {
 
 Ptr<ast::ErrorPtrn> Parser::parse_error_ptrn() {
     Tracker tracker(this);
-    error(ahead().loc(), "expected pattern, got '{}'", ahead().string());
+    error(lexer_.loc(ahead()), "expected pattern, got '{}'", lexer_.string(ahead()));
     next();
     return make_ptr<ast::ErrorPtrn>(tracker());
 }
@@ -563,7 +563,7 @@ Ptr<ast::BlockExpr> Parser::parse_block_expr() {
             case Token::Let:
             case Token::Fn:
                 if (!last_semi && !stmts.empty() && stmts.back()->needs_semicolon())
-                    error(ahead().loc(), "expected ';', but got '{}'", ahead().string());
+                    error(lexer_.loc(ahead()), "expected ';', but got '{}'", lexer_.string(ahead()));
                 last_semi = false;
                 stmts.emplace_back(parse_stmt());
                 continue;
@@ -625,8 +625,8 @@ Ptr<ast::CallExpr> Parser::parse_call_expr(Ptr<ast::Expr>&& callee) {
 Ptr<ast::ProjExpr> Parser::parse_proj_expr(Ptr<ast::Expr>&& expr) {
     Tracker tracker(this, expr->loc);
     eat(Token::Dot);
-    if (ahead().is_literal() && ahead().literal().is_integer()) {
-        size_t index = ahead().literal().as_integer();
+    if (ahead().is_literal() && lexer_.literal(ahead()).is_integer()) {
+        size_t index = lexer_.literal(ahead()).as_integer();
         eat(Token::Lit);
         return make_ptr<ast::ProjExpr>(tracker(), std::move(expr), index);
     } else {
@@ -724,7 +724,7 @@ Ptr<ast::Expr> Parser::parse_for_expr() {
     auto call_loc = expr->loc;
     Ptr<ast::CallExpr> call(expr->isa<ast::CallExpr>() ? expr.release()->as<ast::CallExpr>() : nullptr);
     if (!call) {
-        error(ahead().loc(), "invalid for loop expression");
+        error(lexer_.loc(ahead()), "invalid for loop expression");
         return make_ptr<ast::ErrorExpr>(tracker());
     }
 
@@ -939,7 +939,7 @@ parse_opts:
     goto done;
 
 error:
-    error(ahead().loc(), "expected ':', or ')' in assembly expression");
+    error(lexer_.loc(ahead()), "expected ':', or ')' in assembly expression");
 
 done:
     return make_ptr<ast::AsmExpr>(
@@ -950,7 +950,7 @@ done:
 
 Ptr<ast::ErrorExpr> Parser::parse_error_expr() {
     Tracker tracker(this);
-    error(ahead().loc(), "expected expression, got '{}'", ahead().string());
+    error(lexer_.loc(ahead()), "expected expression, got '{}'", lexer_.string(ahead()));
     next();
     return make_ptr<ast::ErrorExpr>(tracker());
 }
@@ -973,7 +973,7 @@ Ptr<ast::Type> Parser::parse_type() {
 }
 
 Ptr<ast::Type> Parser::parse_named_type() {
-    auto tag = ast::PrimType::tag_from_token(ahead());
+    auto tag = ast::PrimType::tag_from_name(lexer_.identifier(ahead()));
     if (tag != ast::PrimType::Error)
         return parse_prim_type(tag);
     return parse_type_app();
@@ -1047,7 +1047,7 @@ Ptr<ast::TypeApp> Parser::parse_type_app() {
 
 Ptr<ast::ErrorType> Parser::parse_error_type() {
     Tracker tracker(this);
-    error(ahead().loc(), "expected type, got '{}'", ahead().string());
+    error(lexer_.loc(ahead()), "expected type, got '{}'", lexer_.string(ahead()));
     next();
     return make_ptr<ast::ErrorType>(tracker());
 }
@@ -1076,22 +1076,22 @@ Ptr<ast::AttrList> Parser::parse_attr_list() {
 
 Ptr<ast::Attr> Parser::parse_attr() {
     Tracker tracker(this);
-    std::string name;
+    Name name;
     if (ahead().tag() == Token::Id)
-        name = ahead().identifier();
+        name = lexer_.identifier(ahead());
     expect(Token::Id);
 
     if (accept(Token::Eq)) {
         if (ahead().tag() == Token::Lit) {
-            auto lit = ahead().literal();
+            auto lit = lexer_.literal(ahead());
             eat(Token::Lit);
-            return make_ptr<ast::LiteralAttr>(tracker(), std::move(name), lit);
+            return make_ptr<ast::LiteralAttr>(tracker(), name, lit);
         } else if (ahead().tag() == Token::Id) {
             auto path = parse_path();
-            return make_ptr<ast::PathAttr>(tracker(), std::move(name), std::move(path));
+            return make_ptr<ast::PathAttr>(tracker(), name, std::move(path));
         } else {
-            error(ahead().loc(), "expected attribute value, got '{}'", ahead().string());
-            return make_ptr<ast::NamedAttr>(tracker(), std::move(name), PtrVector<ast::Attr>());
+            error(lexer_.loc(ahead()), "expected attribute value, got '{}'", lexer_.string(ahead()));
+            return make_ptr<ast::NamedAttr>(tracker(), name, PtrVector<ast::Attr>());
         }
     } else {
         PtrVector<ast::Attr> args;
@@ -1100,7 +1100,7 @@ Ptr<ast::Attr> Parser::parse_attr() {
                 args.emplace_back(parse_attr());
             });
         }
-        return make_ptr<ast::NamedAttr>(tracker(), std::move(name), std::move(args));
+        return make_ptr<ast::NamedAttr>(tracker(), name, std::move(args));
     }
 }
 
@@ -1121,7 +1121,7 @@ ast::Path Parser::parse_path(ast::Identifier&& id, bool allow_types) {
         if (ahead().tag() != Token::DblColon)
             break;
         eat(Token::DblColon);
-        prev_loc = ahead().loc();
+        prev_loc = lexer_.loc(ahead());
         id = parse_id();
     } while (true) ;
 
@@ -1130,13 +1130,13 @@ ast::Path Parser::parse_path(ast::Identifier&& id, bool allow_types) {
 
 ast::Identifier Parser::parse_id() {
     Tracker tracker(this);
-    std::string ident;
+    Name ident;
     if (ahead().is_identifier())
-        ident = ahead().identifier();
+        ident = lexer_.identifier(ahead());
     else
-        error(ahead().loc(), "expected identifier, got '{}'", ahead().string());
+        error(lexer_.loc(ahead()), "expected identifier, got '{}'", lexer_.string(ahead()));
     next();
-    return ast::Identifier(tracker(), std::move(ident));
+    return ast::Identifier(tracker(), ident);
 }
 
 ast::AsmExpr::Constr Parser::parse_constr() {
@@ -1151,30 +1151,30 @@ ast::AsmExpr::Constr Parser::parse_constr() {
 Literal Parser::parse_lit() {
     Literal lit;
     if (!ahead().is_literal())
-        error(ahead().loc(), "expected literal, got '{}'", ahead().string());
+        error(lexer_.loc(ahead()), "expected literal, got '{}'", lexer_.string(ahead()));
     else
-        lit = ahead().literal();
+        lit = lexer_.literal(ahead());
     next();
     return lit;
 }
 
 std::string Parser::parse_str() {
     std::string str;
-    if (!ahead().is_literal() || !ahead().literal().is_string())
-        error(ahead().loc(), "expected string literal, got '{}'", ahead().string());
+    if (!ahead().is_literal() || !lexer_.literal(ahead()).is_string())
+        error(lexer_.loc(ahead()), "expected string literal, got '{}'", lexer_.string(ahead()));
     else
-        str = ahead().literal().as_string();
+        str = lexer_.literal(ahead()).as_string();
     next();
     return str;
 }
 
 std::optional<size_t> Parser::parse_array_size() {
     std::optional<size_t> size;
-    if (ahead().is_literal() && ahead().literal().is_integer()) {
-        size = ahead().literal().as_integer();
+    if (ahead().is_literal() && lexer_.literal(ahead()).is_integer()) {
+        size = lexer_.literal(ahead()).as_integer();
         eat(Token::Lit);
     } else {
-        error(ahead().loc(), "expected integer literal as array size");
+        error(lexer_.loc(ahead()), "expected integer literal as array size");
         if (ahead().tag() != Token::RBracket)
             next();
     }
@@ -1186,8 +1186,8 @@ size_t Parser::parse_addr_space() {
     expect(Token::LParen);
     Tracker tracker(this);
     size_t addr_space = 0;
-    if (ahead().is_literal() && ahead().literal().is_integer()) {
-        addr_space = ahead().literal().as_integer();
+    if (ahead().is_literal() && lexer_.literal(ahead()).is_integer()) {
+        addr_space = lexer_.literal(ahead()).as_integer();
         next();
     } else
         error(tracker(), "invalid address space");
@@ -0,0 +1,1154 @@
+#include <algorithm>
+#include <cstring>
+
+#include "artic/serialize.h"
+
+namespace artic {
+
+static constexpr char magic[] = { 'a', 'r', 't', 'c' };
+static constexpr uint8_t attrs_flag = 0x80;
+
+// Locations start with a byte giving their form. Short locations hold their offset
+// from the previous location in bits 1-3 of that byte, and their size in bits 4-7.
+struct LocForm {
+    enum : uint8_t {
+        Same  = 0,  ///< Same location as the previous one
+        Short = 1,  ///< Same row as the previous location, small offset and size
+        Row   = 2,  ///< Same row as the previous location
+        Long  = 4   ///< Any other location
+    };
+};
+static constexpr int short_loc_max_offset = 7;
+static constexpr int short_loc_max_size   = 15;
+
+// Signed integers are interleaved with unsigned ones, so that small negative numbers remain small
+static uint64_t zigzag(int64_t i) { return (uint64_t(i) << 1) ^ uint64_t(i >> 63); }
+static int64_t unzigzag(uint64_t u) { return int64_t(u >> 1) ^ -int64_t(u & 1); }
+
+/// Returns true if nodes with the given tag are of type `T`.
+template <typename T> bool is_a(NodeTag);
+
+template <NodeTag First, NodeTag Last>
+static bool in_range(NodeTag tag) { return tag >= First && tag <= Last; }
+
+template <> bool is_a<ast::Filter>(NodeTag tag)        { return tag == NodeTag::Filter; }
+template <> bool is_a<ast::TypeParamList>(NodeTag tag) { return tag == NodeTag::TypeParamList; }
+template <> bool is_a<ast::AttrList>(NodeTag tag)      { return tag == NodeTag::AttrList; }
+template <> bool is_a<ast::FieldExpr>(NodeTag tag)     { return tag == NodeTag::FieldExpr; }
+template <> bool is_a<ast::FnExpr>(NodeTag tag)        { return tag == NodeTag::FnExpr; }
+template <> bool is_a<ast::CallExpr>(NodeTag tag)      { return tag == NodeTag::CallExpr; }
+template <> bool is_a<ast::CaseExpr>(NodeTag tag)      { return tag == NodeTag::CaseExpr; }
+template <> bool is_a<ast::FieldPtrn>(NodeTag tag)     { return tag == NodeTag::FieldPtrn; }
+template <> bool is_a<ast::TypeParam>(NodeTag tag)     { return tag == NodeTag::TypeParam; }
+template <> bool is_a<ast::PtrnDecl>(NodeTag tag)      { return tag == NodeTag::PtrnDecl; }
+template <> bool is_a<ast::FieldDecl>(NodeTag tag)     { return tag == NodeTag::FieldDecl; }
+template <> bool is_a<ast::OptionDecl>(NodeTag tag)    { return tag == NodeTag::OptionDecl; }
+template <> bool is_a<ast::ModDecl>(NodeTag tag)       { return tag == NodeTag::ModDecl; }
+template <> bool is_a<ast::Attr>(NodeTag tag) { return in_range<NodeTag::FirstAttr, NodeTag::LastAttr>(tag); }
+template <> bool is_a<ast::Type>(NodeTag tag) { return in_range<NodeTag::FirstType, NodeTag::LastType>(tag); }
+template <> bool is_a<ast::Stmt>(NodeTag tag) { return in_range<NodeTag::FirstStmt, NodeTag::LastStmt>(tag); }
+template <> bool is_a<ast::Expr>(NodeTag tag) { return in_range<NodeTag::FirstExpr, NodeTag::LastExpr>(tag); }
+template <> bool is_a<ast::Ptrn>(NodeTag tag) { return in_range<NodeTag::FirstPtrn, NodeTag::LastPtrn>(tag); }
+template <> bool is_a<ast::Decl>(NodeTag tag) { return in_range<NodeTag::FirstDecl, NodeTag::LastDecl>(tag); }
+
+// Serializer ----------------------------------------------------------------------
+
+Serializer::Serializer(std::string& buffer)
+    : buffer_(buffer)
+{
+    buffer_.append(magic, sizeof(magic));
+    write_uint(version);
+}
+
+void Serializer::write_long_uint(uint64_t u) {
+    while (u >= 0x80) {
+        buffer_.push_back(char(u | 0x80));
+        u >>= 7;
+    }
+    buffer_.push_back(char(u));
+}
+
+void Serializer::write_int(int64_t i) {
+    write_uint(zigzag(i));
+}
+
+void Serializer::write_string(std::string_view str) {
+    write_uint(str.size());
+    buffer_.append(str.data(), str.size());
+}
+
+void Serializer::write_name(Name name) {
+    // Names are indexed by their identifier, which is faster than hashing them
+    if (name.id() >= name_indices_.size())
+        name_indices_.resize(std::max(size_t(name.id()) + 1, name_indices_.size() * 2));
+    auto& index = name_indices_[name.id()];
+    if (index != 0) {
+        write_uint(index - 1);
+        return;
+    }
+    index = ++name_count_;
+    write_uint(index - 1);
+    write_string(name.str());
+}
+
+void Serializer::write_loc(const Loc& loc) {
+    // Locations start with a byte giving their form (see `LocForm`). Nodes often have the same
+    // location as the previous one (e.g. paths and their identifiers), and most of the others
+    // fit on a single row and begin shortly after the previous one, since nodes are written in
+    // pre-order: Those are written in a single byte, with their offset and their size.
+    auto& prev = prev_loc_;
+    if (loc.begin.row == prev.begin.row && loc.begin.col == prev.begin.col &&
+        loc.end.row == prev.end.row && loc.end.col == prev.end.col) {
+        buffer_.push_back(char(LocForm::Same));
+        return;
+    }
+    auto offset = int64_t(loc.begin.col) - prev.begin.col;
+    auto size = int64_t(loc.end.col) - loc.begin.col;
+    if (loc.begin.row == prev.begin.row && loc.end.row == loc.begin.row) {
+        if (offset >= 0 && offset <= short_loc_max_offset && size >= 0 && size <= short_loc_max_size)
+            buffer_.push_back(char(LocForm::Short | offset << 1 | size << 4));
+        else {
+            buffer_.push_back(char(LocForm::Row));
+            write_int(offset);
+            write_int(size);
+        }
+    } else {
+        // Rows are written relative to the previous location, and columns
+        // relative to the beginning of the row when it is the same
+        buffer_.push_back(char(LocForm::Long));
+        write_int(loc.begin.row - prev.begin.row);
+        write_int(loc.begin.row == prev.begin.row ? offset : loc.begin.col);
+        write_int(loc.end.row - loc.begin.row);
+        write_int(loc.end.row == loc.begin.row ? size : loc.end.col);
+    }
+    prev = loc;
+}
+
+void Serializer::write_id(const ast::Identifier& id) {
+    write_loc(id.loc);
+    write_name(id.name);
+}
+
+void Serializer::write_literal(const Literal& lit) {
+    write_uint(lit.tag);
+    switch (lit.tag) {
+        case Literal::Char:    write_uint(lit.as_char());    break;
+        case Literal::String:  write_string(lit.as_string()); break;
+        case Literal::Integer: write_uint(lit.as_integer()); break;
+        case Literal::Bool:    write_bool(lit.as_bool());    break;
+        case Literal::Double: {
+            // Doubles are written as their bit pattern, in little-endian order
+            uint64_t bits;
+            auto d = lit.as_double();
+            std::memcpy(&bits, &d, sizeof(bits));
+            for (size_t i = 0; i < sizeof(bits); ++i, bits >>= 8)
+                buffer_.push_back(char(bits & 0xFF));
+            break;
+        }
+    }
+}
+
+void Serializer::write_node(NodeTag tag, const ast::Node& node) {
+    buffer_.push_back(char(uint8_t(tag) | (node.attrs ? attrs_flag : 0)));
+    write_loc(node.loc);
+    if (node.attrs)
+        write_ptr(node.attrs);
+}
+
+// Deserializer --------------------------------------------------------------------
+
+Deserializer::Deserializer(std::string_view data, uint32_t file)
+    : data_(data), file_(file), prev_loc_(file, 0, 0)
+{
+    if (data_.size() < sizeof(magic) || std::memcmp(data_.data(), magic, sizeof(magic)) != 0) {
+        fail();
+        return;
+    }
+    pos_ = sizeof(magic);
+    if (read_uint() != Serializer::version)
+        fail();
+}
+
+uint64_t Deserializer::read_long_uint() {
+    uint64_t u = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos_ >= data_.size())
+            break;
+        auto byte = uint8_t(data_[pos_++]);
+        u |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return u;
+    }
+    return fail(), 0;
+}
+
+int64_t Deserializer::read_int() {
+    return unzigzag(read_uint());
+}
+
+size_t Deserializer::read_size() {
+    auto size = read_uint();
+    if (size > data_.size() - pos_)
+        return fail(), 0;
+    return size;
+}
+
+std::string_view Deserializer::read_string() {
+    auto size = read_size();
+    auto str = data_.substr(pos_, size);
+    pos_ += size;
+    return str;
+}
+
+Name Deserializer::read_name() {
+    auto index = read_uint();
+    if (index < names_.size())
+        return names_[index];
+    if (index > names_.size())
+        return fail(), Name();
+    return names_.emplace_back(read_string());
+}
+
+Loc Deserializer::read_loc() {
+    auto& prev = prev_loc_;
+    if (pos_ >= data_.size())
+        return fail(), prev;
+    auto form = uint8_t(data_[pos_++]);
+    if (form == LocForm::Same)
+        return prev;
+    Loc loc;
+    loc.file = file_;
+    if (form & LocForm::Short) {
+        loc.begin.row = loc.end.row = prev.begin.row;
+        loc.begin.col = prev.begin.col + ((form >> 1) & short_loc_max_offset);
+        loc.end.col = loc.begin.col + (form >> 4);
+    } else if (form == LocForm::Row) {
+        loc.begin.row = loc.end.row = prev.begin.row;
+        loc.begin.col = prev.begin.col + read_int();
+        loc.end.col = loc.begin.col + read_int();
+    } else if (form == LocForm::Long) {
+        loc.begin.row = prev.begin.row + read_int();
+        loc.begin.col = read_int() + (loc.begin.row == prev.begin.row ? prev.begin.col : 0);
+        loc.end.row = loc.begin.row + read_int();
+        loc.end.col = read_int() + (loc.end.row == loc.begin.row ? loc.begin.col : 0);
+    } else
+        return fail(), prev;
+    return prev = loc;
+}
+
+ast::Identifier Deserializer::read_id() {
+    auto loc = read_loc();
+    return ast::Identifier(loc, read_name());
+}
+
+Literal Deserializer::read_literal() {
+    switch (read_enum(Literal::Bool)) {
+        case Literal::Char:    return Literal(uint8_t(read_uint()));
+        case Literal::String:  return Literal(std::string(read_string()));
+        case Literal::Integer: return Literal(uint64_t(read_uint()));
+        case Literal::Bool:    return Literal(read_bool());
+        case Literal::Double: {
+            if (data_.size() - pos_ < sizeof(uint64_t))
+                return fail(), Literal(0.0);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < sizeof(bits); ++i)
+                bits |= uint64_t(uint8_t(data_[pos_++])) << (i * 8);
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            return Literal(d);
+        }
+    }
+    return Literal();
+}
+
+template <typename T>
+Ptr<T> Deserializer::read_ptr() {
+    // The tag is checked before the node is read, which is simpler than checking its type afterwards
+    if (pos_ < data_.size()) {
+        auto tag = NodeTag(uint8_t(data_[pos_]) & ~attrs_flag);
+        if (tag != NodeTag::Null && !is_a<T>(tag))
+            return fail(), nullptr;
+    }
+    return Ptr<T>(static_cast<T*>(read_node().release()));
+}
+
+template <typename T>
+Ptr<T> Deserializer::read_required_ptr() {
+    auto ptr = read_ptr<T>();
+    if (!ptr)
+        fail();
+    return ptr;
+}
+
+template <typename T>
+PtrVector<T> Deserializer::read_ptrs() {
+    PtrVector<T> ptrs(read_size());
+    for (auto& ptr : ptrs)
+        ptr = read_required_ptr<T>();
+    return ptrs;
+}
+
+ast::Path Deserializer::read_path() {
+    auto loc = read_loc();
+    std::vector<ast::Path::Elem> elems;
+    // Paths always have at least one element
+    auto elem_count = read_size();
+    if (elem_count == 0)
+        fail();
+    for (auto i = elem_count; i > 0; --i) {
+        auto elem_loc = read_loc();
+        auto id = read_id();
+        auto args = read_ptrs<ast::Type>();
+        elems.emplace_back(elem_loc, std::move(id), std::move(args));
+    }
+    return ast::Path(loc, std::move(elems));
+}
+
+Ptr<ast::Node> Deserializer::read_node() {
+    if (pos_ >= data_.size())
+        return fail(), nullptr;
+    auto byte = uint8_t(data_[pos_++]);
+    auto tag = NodeTag(byte & ~attrs_flag);
+    if (tag == NodeTag::Null && !(byte & attrs_flag))
+        return nullptr;
+    if (tag == NodeTag::Null || tag > NodeTag::LastDecl)
+        return fail(), nullptr;
+
+    auto loc = read_loc();
+    Ptr<ast::AttrList> attrs;
+    if (byte & attrs_flag)
+        attrs = read_required_ptr<ast::AttrList>();
+
+    // Fields are read in separate statements, since the order in which arguments are evaluated is unspecified
+    Ptr<ast::Node> node;
+    switch (tag) {
+        case NodeTag::Filter: {
+            auto expr = read_ptr<ast::Expr>();
+            node = make_ptr<ast::Filter>(loc, std::move(expr));
+            break;
+        }
+        case NodeTag::PathAttr: {
+            auto name = read_name();
+            auto path = read_path();
+            node = make_ptr<ast::PathAttr>(loc, name, std::move(path));
+            break;
+        }
+        case NodeTag::LiteralAttr: {
+            auto name = read_name();
+            auto lit = read_literal();
+            node = make_ptr<ast::LiteralAttr>(loc, name, lit);
+            break;
+        }
+        case NodeTag::NamedAttr: {
+            auto name = read_name();
+            auto args = read_ptrs<ast::Attr>();
+            node = make_ptr<ast::NamedAttr>(loc, name, std::move(args));
+            break;
+        }
+        case NodeTag::AttrList:
+            node = make_ptr<ast::AttrList>(loc, read_ptrs<ast::Attr>());
+            break;
+        case NodeTag::TypeParamList:
+            node = make_ptr<ast::TypeParamList>(loc, read_ptrs<ast::TypeParam>());
+            break;
+
+        // Types
+        case NodeTag::PrimType:
+            node = make_ptr<ast::PrimType>(loc, read_enum(ast::PrimType::Error));
+            break;
+        case NodeTag::TupleType:
+            node = make_ptr<ast::TupleType>(loc, read_ptrs<ast::Type>());
+            break;
+        case NodeTag::SizedArrayType: {
+            auto elem = read_required_ptr<ast::Type>();
+            auto size = read_uint();
+            auto is_simd = read_bool();
+            node = make_ptr<ast::SizedArrayType>(loc, std::move(elem), size, is_simd);
+            break;
+        }
+        case NodeTag::UnsizedArrayType:
+            node = make_ptr<ast::UnsizedArrayType>(loc, read_required_ptr<ast::Type>());
+            break;
+        case NodeTag::FnType: {
+            auto from = read_required_ptr<ast::Type>();
+            auto to = read_required_ptr<ast::Type>();
+            node = make_ptr<ast::FnType>(loc, std::move(from), std::move(to));
+            break;
+        }
+        case NodeTag::PtrType: {
+            auto pointee = read_required_ptr<ast::Type>();
+            auto is_mut = read_bool();
+            auto addr_space = read_uint();
+            node = make_ptr<ast::PtrType>(loc, std::move(pointee), is_mut, addr_space);
+            break;
+        }
+        case NodeTag::TypeApp:
+            node = make_ptr<ast::TypeApp>(loc, read_path());
+            break;
+        case NodeTag::ErrorType:
+            node = make_ptr<ast::ErrorType>(loc);
+            break;
+
+        // Statements
+        case NodeTag::DeclStmt:
+            node = make_ptr<ast::DeclStmt>(loc, read_required_ptr<ast::Decl>());
+            break;
+        case NodeTag::ExprStmt:
+            node = make_ptr<ast::ExprStmt>(loc, read_required_ptr<ast::Expr>());
+            break;
+
+        // Expressions
+        case NodeTag::TypedExpr: {
+            auto expr = read_required_ptr<ast::Expr>();
+            auto type = read_required_ptr<ast::Type>();
+            node = make_ptr<ast::TypedExpr>(loc, std::move(expr), std::move(type));
+            break;
+        }
+        case NodeTag::PathExpr:
+            node = make_ptr<ast::PathExpr>(read_path());
+            break;
+        case NodeTag::LiteralExpr:
+            node = make_ptr<ast::LiteralExpr>(loc, read_literal());
+            break;
+        case NodeTag::FieldExpr: {
+            auto id = read_id();
+            auto expr = read_required_ptr<ast::Expr>();
+            node = make_ptr<ast::FieldExpr>(loc, std::move(id), std::move(expr));
+            break;
+        }
+        case NodeTag::RecordExpr: {
+            auto type = read_ptr<ast::Type>();
+            auto expr = read_ptr<ast::Expr>();
+            auto fields = read_ptrs<ast::FieldExpr>();
+            auto record_expr = make_ptr<ast::RecordExpr>(loc, std::move(type), std::move(fields));
+            record_expr->expr = std::move(expr);
+            node = std::move(record_expr);
+            break;
+        }
+        case NodeTag::TupleExpr:
+            node = make_ptr<ast::TupleExpr>(loc, read_ptrs<ast::Expr>());
+            break;
+        case NodeTag::ArrayExpr: {
+            auto elems = read_ptrs<ast::Expr>();
+            auto is_simd = read_bool();
+            node = make_ptr<ast::ArrayExpr>(loc, std::move(elems), is_simd);
+            break;
+        }
+        case NodeTag::RepeatArrayExpr: {
+            auto elem = read_required_ptr<ast::Expr>();
+            auto size = read_uint();
+            auto is_simd = read_bool();
+            node = make_ptr<ast::RepeatArrayExpr>(loc, std::move(elem), size, is_simd);
+            break;
+        }
+        case NodeTag::FnExpr: {
+            auto filter = read_ptr<ast::Filter>();
+            auto param = read_ptr<ast::Ptrn>();
+            auto ret_type = read_ptr<ast::Type>();
+            auto body = read_ptr<ast::Expr>();
+            node = make_ptr<ast::FnExpr>(loc, std::move(filter), std::move(param), std::move(ret_type), std::move(body));
+            break;
+        }
+        case NodeTag::BlockExpr: {
+            auto stmts = read_ptrs<ast::Stmt>();
+            auto last_semi = read_bool();
+            node = make_ptr<ast::BlockExpr>(loc, std::move(stmts), last_semi);
+            break;
+        }
+        case NodeTag::CallExpr: {
+            auto callee = read_required_ptr<ast::Expr>();
+            auto arg = read_required_ptr<ast::Expr>();
+            node = make_ptr<ast::CallExpr>(loc, std::move(callee), std::move(arg));
+            break;
+        }
+        case NodeTag::ProjExpr: {
+            auto expr = read_required_ptr<ast::Expr>();
+            if (read_bool())
+                node = make_ptr<ast::ProjExpr>(loc, std::move(expr), size_t(read_uint()));
+            else
+                node = make_ptr<ast::ProjExpr>(loc, std::move(expr), read_id());
+            break;
+        }
+        case NodeTag::IfExpr: {
+            auto ptrn = read_ptr<ast::Ptrn>();
+            auto expr = read_ptr<ast::Expr>();
+            auto cond = read_ptr<ast::Expr>();
+            auto if_true = read_required_ptr<ast::Expr>();
+            auto if_false = read_ptr<ast::Expr>();
+            auto if_expr = make_ptr<ast::IfExpr>(loc, std::move(cond), std::move(if_true), std::move(if_false));
+            if_expr->ptrn = std::move(ptrn);
+            if_expr->expr = std::move(expr);
+            node = std::move(if_expr);
+            break;
+        }
+        case NodeTag::CaseExpr: {
+            auto ptrn = read_required_ptr<ast::Ptrn>();
+            auto expr = read_required_ptr<ast::Expr>();
+            node = make_ptr<ast::CaseExpr>(loc, std::move(ptrn), std::move(expr));
+            break;
+        }
+        case NodeTag::MatchExpr: {
+            auto arg = read_required_ptr<ast::Expr>();
+            auto cases = read_ptrs<ast::CaseExpr>();
+            node = make_ptr<ast::MatchExpr>(loc, std::move(arg), std::move(cases));
+            break;
+        }
+        case NodeTag::WhileExpr: {
+            auto ptrn = read_ptr<ast::Ptrn>();
+            auto expr = read_ptr<ast::Expr>();
+            auto cond = read_ptr<ast::Expr>();
+            auto body = read_required_ptr<ast::Expr>();
+            auto while_expr = make_ptr<ast::WhileExpr>(loc, std::move(cond), std::move(body));
+            while_expr->ptrn = std::move(ptrn);
+            while_expr->expr = std::move(expr);
+            node = std::move(while_expr);
+            break;
+        }
+        case NodeTag::ForExpr:
+            node = make_ptr<ast::ForExpr>(loc, read_required_ptr<ast::CallExpr>());
+            break;
+        case NodeTag::BreakExpr:
+            node = make_ptr<ast::BreakExpr>(loc);
+            break;
+        case NodeTag::ContinueExpr:
+            node = make_ptr<ast::ContinueExpr>(loc);
+            break;
+        case NodeTag::ReturnExpr:
+            node = make_ptr<ast::ReturnExpr>(loc);
+            break;
+        case NodeTag::UnaryExpr: {
+            auto unary_tag = read_enum(ast::UnaryExpr::Error);
+            auto arg = read_required_ptr<ast::Expr>();
+            node = make_ptr<ast::UnaryExpr>(loc, unary_tag, std::move(arg));
+            break;
+        }
+        case NodeTag::BinaryExpr: {
+            auto binary_tag = read_enum(ast::BinaryExpr::Error);
+            auto left = read_required_ptr<ast::Expr>();
+            auto right = read_required_ptr<ast::Expr>();
+            node = make_ptr<ast::BinaryExpr>(loc, binary_tag, std::move(left), std::move(right));
+            break;
+        }
+        case NodeTag::FilterExpr: {
+            auto filter = read_required_ptr<ast::Filter>();
+            auto expr = read_required_ptr<ast::Expr>();
+            node = make_ptr<ast::FilterExpr>(loc, std::move(filter), std::move(expr));
+            break;
+        }
+        case NodeTag::CastExpr: {
+            auto expr = read_required_ptr<ast::Expr>();
+            auto type = read_required_ptr<ast::Type>();
+            node = make_ptr<ast::CastExpr>(loc, std::move(expr), std::move(type));
+            break;
+        }
+        case NodeTag::ImplicitCastExpr:
+            node = make_ptr<ast::ImplicitCastExpr>(loc, read_required_ptr<ast::Expr>(), nullptr);
+            break;
+        case NodeTag::AsmExpr: {
+            auto read_constrs = [&] {
+                std::vector<ast::AsmExpr::Constr> constrs;
+                for (auto i = read_size(); i > 0; --i) {
+                    auto constr_loc = read_loc();
+                    auto name = std::string(read_string());
+                    auto expr = read_required_ptr<ast::Expr>();
+                    constrs.emplace_back(constr_loc, std::move(name), std::move(expr));
+                }
+                return constrs;
+            };
+            auto read_strings = [&] {
+                std::vector<std::string> strings;
+                for (auto i = read_size(); i > 0; --i)
+                    strings.emplace_back(read_string());
+                return strings;
+            };
+            auto src = std::string(read_string());
+            auto ins = read_constrs();
+            auto outs = read_constrs();
+            auto clobs = read_strings();
+            auto opts = read_strings();
+            node = make_ptr<ast::AsmExpr>(loc, std::move(src), std::move(ins), std::move(outs), std::move(clobs), std::move(opts));
+            break;
+        }
+        case NodeTag::ErrorExpr:
+            node = make_ptr<ast::ErrorExpr>(loc);
+            break;
+
+        // Patterns
+        case NodeTag::TypedPtrn: {
+            auto ptrn = read_ptr<ast::Ptrn>();
+            auto type = read_required_ptr<ast::Type>();
+            node = make_ptr<ast::TypedPtrn>(loc, std::move(ptrn), std::move(type));
+            break;
+        }
+        case NodeTag::IdPtrn: {
+            auto decl = read_required_ptr<ast::PtrnDecl>();
+            auto sub_ptrn = read_ptr<ast::Ptrn>();
+            node = make_ptr<ast::IdPtrn>(loc, std::move(decl), std::move(sub_ptrn));
+            break;
+        }
+        case NodeTag::LiteralPtrn:
+            node = make_ptr<ast::LiteralPtrn>(loc, read_literal());
+            break;
+        case NodeTag::FieldPtrn: {
+            auto id = read_id();
+            auto ptrn = read_ptr<ast::Ptrn>();
+            node = make_ptr<ast::FieldPtrn>(loc, std::move(id), std::move(ptrn));
+            break;
+        }
+        case NodeTag::RecordPtrn: {
+            auto path = read_path();
+            auto fields = read_ptrs<ast::FieldPtrn>();
+            node = make_ptr<ast::RecordPtrn>(loc, std::move(path), std::move(fields));
+            break;
+        }
+        case NodeTag::CtorPtrn: {
+            auto path = read_path();
+            auto arg = read_ptr<ast::Ptrn>();
+            node = make_ptr<ast::CtorPtrn>(loc, std::move(path), std::move(arg));
+            break;
+        }
+        case NodeTag::TuplePtrn:
+            node = make_ptr<ast::TuplePtrn>(loc, read_ptrs<ast::Ptrn>());
+            break;
+        case NodeTag::ArrayPtrn: {
+            auto elems = read_ptrs<ast::Ptrn>();
+            auto is_simd = read_bool();
+            node = make_ptr<ast::ArrayPtrn>(loc, std::move(elems), is_simd);
+            break;
+        }
+        case NodeTag::ErrorPtrn:
+            node = make_ptr<ast::ErrorPtrn>(loc);
+            break;
+
+        // Declarations
+        case NodeTag::TypeParam:
+            node = make_ptr<ast::TypeParam>(loc, read_id());
+            break;
+        case NodeTag::PtrnDecl: {
+            auto id = read_id();
+            auto is_mut = read_bool();
+            node = make_ptr<ast::PtrnDecl>(loc, std::move(id), is_mut);
+            break;
+        }
+        case NodeTag::LetDecl: {
+            auto ptrn = read_required_ptr<ast::Ptrn>();
+            auto init = read_ptr<ast::Expr>();
+            node = make_ptr<ast::LetDecl>(loc, std::move(ptrn), std::move(init));
+            break;
+        }
+        case NodeTag::StaticDecl: {
+            auto id = read_id();
+            auto type = read_ptr<ast::Type>();
+            auto init = read_ptr<ast::Expr>();
+            auto is_mut = read_bool();
+            node = make_ptr<ast::StaticDecl>(loc, std::move(id), std::move(type), std::move(init), is_mut);
+            break;
+        }
+        case NodeTag::FnDecl: {
+            auto id = read_id();
+            auto fn = read_required_ptr<ast::FnExpr>();
+            auto type_params = read_ptr<ast::TypeParamList>();
+            node = make_ptr<ast::FnDecl>(loc, std::move(id), std::move(fn), std::move(type_params));
+            break;
+        }
+        case NodeTag::FieldDecl: {
+            auto id = read_id();
+            auto type = read_required_ptr<ast::Type>();
+            auto init = read_ptr<ast::Expr>();
+            node = make_ptr<ast::FieldDecl>(loc, std::move(id), std::move(type), std::move(init));
+            break;
+        }
+        case NodeTag::StructDecl: {
+            auto id = read_id();
+            auto type_params = read_ptr<ast::TypeParamList>();
+            auto fields = read_ptrs<ast::FieldDecl>();
+            auto is_tuple_like = read_bool();
+            node = make_ptr<ast::StructDecl>(loc, std::move(id), std::move(type_params), std::move(fields), is_tuple_like);
+            break;
+        }
+        case NodeTag::OptionDecl: {
+            auto id = read_id();
+            auto param = read_ptr<ast::Type>();
+            auto fields = read_ptrs<ast::FieldDecl>();
+            auto has_fields = read_bool();
+            node = make_ptr<ast::OptionDecl>(loc, std::move(id), std::move(param), std::move(fields), has_fields);
+            break;
+        }
+        case NodeTag::EnumDecl: {
+            auto id = read_id();
+            auto type_params = read_ptr<ast::TypeParamList>();
+            auto options = read_ptrs<ast::OptionDecl>();
+            node = make_ptr<ast::EnumDecl>(loc, std::move(id), std::move(type_params), std::move(options));
+            break;
+        }
+        case NodeTag::TypeDecl: {
+            auto id = read_id();
+            auto type_params = read_ptr<ast::TypeParamList>();
+            auto aliased_type = read_required_ptr<ast::Type>();
+            node = make_ptr<ast::TypeDecl>(loc, std::move(id), std::move(type_params), std::move(aliased_type));
+            break;
+        }
+        case NodeTag::ModDecl: {
+            auto id = read_id();
+            auto decls = read_ptrs<ast::Decl>();
+            // Declarations are top-level exactly when they appear directly in a module
+            for (auto& decl : decls) {
+                if (decl)
+                    decl->is_top_level = true;
+            }
+            node = make_ptr<ast::ModDecl>(loc, std::move(id), std::move(decls));
+            break;
+        }
+        case NodeTag::ErrorDecl:
+            node = make_ptr<ast::ErrorDecl>(loc);
+            break;
+        default:
+            return fail(), nullptr;
+    }
+    if (!ok_)
+        return nullptr;
+
+    node->loc = loc;
+    node->attrs = std::move(attrs);
+    return node;
+}
+
+std::string serialize(const ast::ModDecl& mod_decl) {
+    std::string buffer;
+    Serializer serializer(buffer);
+    mod_decl.serialize(serializer);
+    return buffer;
+}
+
+Ptr<ast::ModDecl> deserialize(std::string_view data, uint32_t file) {
+    Deserializer deserializer(data, file);
+    auto mod_decl = deserializer.read_required_ptr<ast::ModDecl>();
+    if (!deserializer.ok() || !deserializer.at_end())
+        return nullptr;
+    return mod_decl;
+}
+
+// AST nodes -----------------------------------------------------------------------
+
+namespace ast {
+
+void Path::serialize(Serializer& s) const {
+    s.write_loc(loc);
+    s.write_uint(elems.size());
+    for (auto& elem : elems) {
+        s.write_loc(elem.loc);
+        s.write_id(elem.id);
+        s.write_ptrs(elem.args);
+    }
+}
+
+void Filter::serialize(Serializer& s) const {
+    s.write_node(NodeTag::Filter, *this);
+    s.write_ptr(expr);
+}
+
+// Attributes ----------------------------------------------------------------------
+
+void PathAttr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::PathAttr, *this);
+    s.write_name(name);
+    path.serialize(s);
+}
+
+void LiteralAttr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::LiteralAttr, *this);
+    s.write_name(name);
+    s.write_literal(lit);
+}
+
+void NamedAttr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::NamedAttr, *this);
+    s.write_name(name);
+    s.write_ptrs(args);
+}
+
+void AttrList::serialize(Serializer& s) const {
+    s.write_node(NodeTag::AttrList, *this);
+    s.write_ptrs(args);
+}
+
+// Types ---------------------------------------------------------------------------
+
+void PrimType::serialize(Serializer& s) const {
+    s.write_node(NodeTag::PrimType, *this);
+    s.write_uint(tag);
+}
+
+void TupleType::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TupleType, *this);
+    s.write_ptrs(args);
+}
+
+void SizedArrayType::serialize(Serializer& s) const {
+    s.write_node(NodeTag::SizedArrayType, *this);
+    s.write_ptr(elem);
+    s.write_uint(size);
+    s.write_bool(is_simd);
+}
+
+void UnsizedArrayType::serialize(Serializer& s) const {
+    s.write_node(NodeTag::UnsizedArrayType, *this);
+    s.write_ptr(elem);
+}
+
+void FnType::serialize(Serializer& s) const {
+    s.write_node(NodeTag::FnType, *this);
+    s.write_ptr(from);
+    s.write_ptr(to);
+}
+
+void PtrType::serialize(Serializer& s) const {
+    s.write_node(NodeTag::PtrType, *this);
+    s.write_ptr(pointee);
+    s.write_bool(is_mut);
+    s.write_uint(addr_space);
+}
+
+void TypeApp::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TypeApp, *this);
+    path.serialize(s);
+}
+
+void ErrorType::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ErrorType, *this);
+}
+
+// Statements ----------------------------------------------------------------------
+
+void DeclStmt::serialize(Serializer& s) const {
+    s.write_node(NodeTag::DeclStmt, *this);
+    s.write_ptr(decl);
+}
+
+void ExprStmt::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ExprStmt, *this);
+    s.write_ptr(expr);
+}
+
+// Expressions ---------------------------------------------------------------------
+
+void TypedExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TypedExpr, *this);
+    s.write_ptr(expr);
+    s.write_ptr(type);
+}
+
+void PathExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::PathExpr, *this);
+    path.serialize(s);
+}
+
+void LiteralExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::LiteralExpr, *this);
+    s.write_literal(lit);
+}
+
+void FieldExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::FieldExpr, *this);
+    s.write_id(id);
+    s.write_ptr(expr);
+}
+
+void RecordExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::RecordExpr, *this);
+    s.write_ptr(type);
+    s.write_ptr(expr);
+    s.write_ptrs(fields);
+}
+
+void TupleExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TupleExpr, *this);
+    s.write_ptrs(args);
+}
+
+void ArrayExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ArrayExpr, *this);
+    s.write_ptrs(elems);
+    s.write_bool(is_simd);
+}
+
+void RepeatArrayExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::RepeatArrayExpr, *this);
+    s.write_ptr(elem);
+    s.write_uint(size);
+    s.write_bool(is_simd);
+}
+
+void FnExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::FnExpr, *this);
+    s.write_ptr(filter);
+    s.write_ptr(param);
+    s.write_ptr(ret_type);
+    s.write_ptr(body);
+}
+
+void BlockExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::BlockExpr, *this);
+    s.write_ptrs(stmts);
+    s.write_bool(last_semi);
+}
+
+void CallExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::CallExpr, *this);
+    s.write_ptr(callee);
+    s.write_ptr(arg);
+}
+
+void ProjExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ProjExpr, *this);
+    s.write_ptr(expr);
+    s.write_bool(std::holds_alternative<size_t>(field));
+    if (auto index = std::get_if<size_t>(&field))
+        s.write_uint(*index);
+    else
+        s.write_id(std::get<Identifier>(field));
+}
+
+void IfExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::IfExpr, *this);
+    s.write_ptr(ptrn);
+    s.write_ptr(expr);
+    s.write_ptr(cond);
+    s.write_ptr(if_true);
+    s.write_ptr(if_false);
+}
+
+void CaseExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::CaseExpr, *this);
+    s.write_ptr(ptrn);
+    s.write_ptr(expr);
+}
+
+void MatchExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::MatchExpr, *this);
+    s.write_ptr(arg);
+    s.write_ptrs(cases);
+}
+
+void WhileExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::WhileExpr, *this);
+    s.write_ptr(ptrn);
+    s.write_ptr(expr);
+    s.write_ptr(cond);
+    s.write_ptr(body);
+}
+
+void ForExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ForExpr, *this);
+    s.write_ptr(call);
+}
+
+void BreakExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::BreakExpr, *this);
+}
+
+void ContinueExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ContinueExpr, *this);
+}
+
+void ReturnExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ReturnExpr, *this);
+}
+
+void UnaryExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::UnaryExpr, *this);
+    s.write_uint(tag);
+    s.write_ptr(arg);
+}
+
+void BinaryExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::BinaryExpr, *this);
+    s.write_uint(tag);
+    s.write_ptr(left);
+    s.write_ptr(right);
+}
+
+void FilterExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::FilterExpr, *this);
+    s.write_ptr(filter);
+    s.write_ptr(expr);
+}
+
+void CastExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::CastExpr, *this);
+    s.write_ptr(expr);
+    s.write_ptr(type);
+}
+
+void ImplicitCastExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ImplicitCastExpr, *this);
+    s.write_ptr(expr);
+}
+
+void AsmExpr::serialize(Serializer& s) const {
+    auto write_constrs = [&] (const std::vector<Constr>& constrs) {
+        s.write_uint(constrs.size());
+        for (auto& constr : constrs) {
+            s.write_loc(constr.loc);
+            s.write_string(constr.name);
+            s.write_ptr(constr.expr);
+        }
+    };
+    auto write_strings = [&] (const std::vector<std::string>& strings) {
+        s.write_uint(strings.size());
+        for (auto& str : strings)
+            s.write_string(str);
+    };
+    s.write_node(NodeTag::AsmExpr, *this);
+    s.write_string(src);
+    write_constrs(ins);
+    write_constrs(outs);
+    write_strings(clobs);
+    write_strings(opts);
+}
+
+void ErrorExpr::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ErrorExpr, *this);
+}
+
+// Declarations --------------------------------------------------------------------
+
+void TypeParam::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TypeParam, *this);
+    s.write_id(id);
+}
+
+void TypeParamList::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TypeParamList, *this);
+    s.write_ptrs(params);
+}
+
+void PtrnDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::PtrnDecl, *this);
+    s.write_id(id);
+    s.write_bool(is_mut);
+}
+
+void LetDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::LetDecl, *this);
+    s.write_ptr(ptrn);
+    s.write_ptr(init);
+}
+
+void StaticDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::StaticDecl, *this);
+    s.write_id(id);
+    s.write_ptr(type);
+    s.write_ptr(init);
+    s.write_bool(is_mut);
+}
+
+void FnDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::FnDecl, *this);
+    s.write_id(id);
+    s.write_ptr(fn);
+    s.write_ptr(type_params);
+}
+
+void FieldDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::FieldDecl, *this);
+    s.write_id(id);
+    s.write_ptr(type);
+    s.write_ptr(init);
+}
+
+void StructDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::StructDecl, *this);
+    s.write_id(id);
+    s.write_ptr(type_params);
+    s.write_ptrs(fields);
+    s.write_bool(is_tuple_like);
+}
+
+void OptionDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::OptionDecl, *this);
+    s.write_id(id);
+    s.write_ptr(param);
+    s.write_ptrs(fields);
+    s.write_bool(has_fields);
+}
+
+void EnumDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::EnumDecl, *this);
+    s.write_id(id);
+    s.write_ptr(type_params);
+    s.write_ptrs(options);
+}
+
+void TypeDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TypeDecl, *this);
+    s.write_id(id);
+    s.write_ptr(type_params);
+    s.write_ptr(aliased_type);
+}
+
+void ModDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ModDecl, *this);
+    s.write_id(id);
+    s.write_ptrs(decls);
+}
+
+void ErrorDecl::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ErrorDecl, *this);
+}
+
+// Patterns ------------------------------------------------------------------------
+
+void TypedPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TypedPtrn, *this);
+    s.write_ptr(ptrn);
+    s.write_ptr(type);
+}
+
+void IdPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::IdPtrn, *this);
+    s.write_ptr(decl);
+    s.write_ptr(sub_ptrn);
+}
+
+void LiteralPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::LiteralPtrn, *this);
+    s.write_literal(lit);
+}
+
+void FieldPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::FieldPtrn, *this);
+    s.write_id(id);
+    s.write_ptr(ptrn);
+}
+
+void RecordPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::RecordPtrn, *this);
+    path.serialize(s);
+    s.write_ptrs(fields);
+}
+
+void CtorPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::CtorPtrn, *this);
+    path.serialize(s);
+    s.write_ptr(arg);
+}
+
+void TuplePtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::TuplePtrn, *this);
+    s.write_ptrs(args);
+}
+
+void ArrayPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ArrayPtrn, *this);
+    s.write_ptrs(elems);
+    s.write_bool(is_simd);
+}
+
+void ErrorPtrn::serialize(Serializer& s) const {
+    s.write_node(NodeTag::ErrorPtrn, *this);
+}
+
+} // namespace ast
+
+} // namespace artic
@@ -0,0 +1,101 @@
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+#include "artic/stats.h"
+
+namespace artic {
+
+std::string Stats::type_name(std::type_index type) {
+    std::string name = type.name();
+#ifdef __GNUG__
+    int status = 0;
+    if (auto demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status)) {
+        name = demangled;
+        std::free(demangled);
+    }
+#endif
+    auto pos = name.rfind("::");
+    return pos != std::string::npos ? name.substr(pos + 2) : name;
+}
+
+static std::string format_ms(double seconds) {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(3) << seconds * 1.0e3;
+    return os.str();
+}
+
+void Stats::print(log::Output& out) const {
+    size_t width = 5;
+    for (auto& pass : passes)
+        width = std::max(width, pass.name.size());
+    for (auto& counter : counters)
+        width = std::max(width, counter.first.size());
+    width += 2;
+
+    if (!passes.empty()) {
+        out << log::style(std::string("pass").append(width - 4, ' '), log::Style::White, log::Style::Bold)
+            << log::style("   wall (ms)    cpu (ms)", log::Style::White, log::Style::Bold) << '\n';
+        Pass total { "total" };
+        auto print_pass = [&] (const Pass& pass) {
+            out.stream
+                << std::left  << std::setw(width) << pass.name
+                << std::right << std::setw(12) << format_ms(pass.wall)
+                << std::setw(12) << format_ms(pass.cpu) << '\n';
+        };
+        for (auto& pass : passes) {
+            print_pass(pass);
+            total.wall += pass.wall;
+            total.cpu  += pass.cpu;
+        }
+        print_pass(total);
+    }
+
+    if (!counters.empty()) {
+        if (!passes.empty())
+            out << '\n';
+        out << log::style(std::string("counter").append(width - 7, ' '), log::Style::White, log::Style::Bold)
+            << log::style("       value", log::Style::White, log::Style::Bold) << '\n';
+        for (auto& counter : counters) {
+            out.stream
+                << std::left  << std::setw(width) << counter.first
+                << std::right << std::setw(12) << counter.second << '\n';
+        }
+    }
+}
+
+static void print_json_string(std::ostream& os, const std::string& str) {
+    os << '"';
+    for (auto c : str) {
+        if (c == '"' || c == '\\')
+            os << '\\';
+        os << c;
+    }
+    os << '"';
+}
+
+void Stats::print_json(std::ostream& os) const {
+    os << "{\n  \"passes\": [";
+    for (size_t i = 0; i < passes.size(); ++i) {
+        os << (i > 0 ? ",\n    " : "\n    ") << "{ \"name\": ";
+        print_json_string(os, passes[i].name);
+        os << ", \"wall_ms\": " << format_ms(passes[i].wall)
+           << ", \"cpu_ms\": "  << format_ms(passes[i].cpu) << " }";
+    }
+    os << (passes.empty() ? "],\n" : "\n  ],\n");
+    os << "  \"counters\": {";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        os << (i > 0 ? ",\n    " : "\n    ");
+        print_json_string(os, counters[i].first);
+        os << ": " << counters[i].second;
+    }
+    os << (counters.empty() ? "}\n" : "\n  }\n");
+    os << "}\n";
+}
+
+} // namespace artic
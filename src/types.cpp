@@ -1,4 +1,5 @@
 #include <typeinfo>
+#include <new>
 #include <algorithm>
 
 #include "artic/types.h"
@@ -85,7 +86,8 @@ bool EnumType::equals(const Type* other) const {
 }
 
 bool ModType::equals(const Type* other) const {
-    return other == this;
+    // Module types can be requested several times for the same module (see `Path::infer`)
+    return other->isa<ModType>() && &other->as<ModType>()->decl == &decl;
 }
 
 bool TypeAlias::equals(const Type* other) const {
@@ -101,18 +103,18 @@ bool TypeApp::equals(const Type* other) const {
 
 // Hash ----------------------------------------------------------------------------
 
-size_t PrimType::hash() const {
+size_t PrimType::compute_hash() const {
     return fnv::Hash().combine(typeid(*this).hash_code()).combine(tag);
 }
 
-size_t TupleType::hash() const {
+size_t TupleType::compute_hash() const {
     auto h = fnv::Hash().combine(typeid(*this).hash_code());
     for (auto a : args)
         h.combine(a);
     return h;
 }
 
-size_t SizedArrayType::hash() const {
+size_t SizedArrayType::compute_hash() const {
     return fnv::Hash()
         .combine(typeid(*this).hash_code())
         .combine(elem)
@@ -120,59 +122,59 @@ size_t SizedArrayType::hash() const {
         .combine(is_simd);
 }
 
-size_t UnsizedArrayType::hash() const {
+size_t UnsizedArrayType::compute_hash() const {
     return fnv::Hash()
         .combine(typeid(*this).hash_code())
         .combine(elem);
 }
 
-size_t AddrType::hash() const {
+size_t AddrType::compute_hash() const {
     return fnv::Hash()
         .combine(typeid(*this).hash_code())
         .combine(pointee)
         .combine(is_mut);
 }
 
-size_t FnType::hash() const {
+size_t FnType::compute_hash() const {
     return fnv::Hash()
         .combine(typeid(*this).hash_code())
         .combine(dom)
         .combine(codom);
 }
 
-size_t BottomType::hash() const {
+size_t BottomType::compute_hash() const {
     return fnv::Hash().combine(typeid(*this).hash_code());
 }
 
-size_t TopType::hash() const {
+size_t TopType::compute_hash() const {
     return fnv::Hash().combine(typeid(*this).hash_code());
 }
 
-size_t TypeVar::hash() const {
+size_t TypeVar::compute_hash() const {
     return fnv::Hash().combine(&param);
 }
 
-size_t ForallType::hash() const {
+size_t ForallType::compute_hash() const {
     return fnv::Hash().combine(&decl);
 }
 
-size_t StructType::hash() const {
+size_t StructType::compute_hash() const {
     return fnv::Hash().combine(&decl);
 }
 
-size_t EnumType::hash() const {
+size_t EnumType::compute_hash() const {
     return fnv::Hash().combine(&decl);
 }
 
-size_t ModType::hash() const {
+size_t ModType::compute_hash() const {
     return fnv::Hash().combine(&decl);
 }
 
-size_t TypeAlias::hash() const {
+size_t TypeAlias::compute_hash() const {
     return fnv::Hash().combine(&decl);
 }
 
-size_t TypeApp::hash() const {
+size_t TypeApp::compute_hash() const {
     auto h = fnv::Hash().combine(typeid(*this).hash_code()).combine(applied);
     for (auto a : type_args)
         h.combine(a);
@@ -212,43 +214,51 @@ bool TypeApp::contains(const Type* type) const {
 
 // Replace -------------------------------------------------------------------------
 
-const Type* TupleType::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
+const Type* Type::replace(const TypeVarMap<const Type*>& map) const {
+    return map.empty() ? this : replace(type_table.subst(map));
+}
+
+const Type* Type::replace(const TypeSubst& subst) const {
+    return type_table.replace(this, subst);
+}
+
+const Type* TupleType::replace_uncached(const TypeSubst& subst) const {
     SmallArray<const Type*> new_args(args.size());
     for (size_t i = 0, n = args.size(); i < n; ++i)
-        new_args[i] = args[i]->replace(map);
+        new_args[i] = args[i]->replace(subst);
     return type_table.tuple_type(std::move(new_args));
 }
 
-const Type* SizedArrayType::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
-    return type_table.sized_array_type(elem->replace(map), size, is_simd);
+const Type* SizedArrayType::replace_uncached(const TypeSubst& subst) const {
+    return type_table.sized_array_type(elem->replace(subst), size, is_simd);
 }
 
-const Type* UnsizedArrayType::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
-    return type_table.unsized_array_type(elem->replace(map));
+const Type* UnsizedArrayType::replace_uncached(const TypeSubst& subst) const {
+    return type_table.unsized_array_type(elem->replace(subst));
 }
 
-const Type* PtrType::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
-    return type_table.ptr_type(pointee->replace(map), is_mut, addr_space);
+const Type* PtrType::replace_uncached(const TypeSubst& subst) const {
+    return type_table.ptr_type(pointee->replace(subst), is_mut, addr_space);
 }
 
-const Type* RefType::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
-    return type_table.ref_type(pointee->replace(map), is_mut, addr_space);
+const Type* RefType::replace_uncached(const TypeSubst& subst) const {
+    return type_table.ref_type(pointee->replace(subst), is_mut, addr_space);
 }
 
-const Type* FnType::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
-    return type_table.fn_type(dom->replace(map), codom->replace(map));
+const Type* FnType::replace_uncached(const TypeSubst& subst) const {
+    return type_table.fn_type(dom->replace(subst), codom->replace(subst));
 }
 
-const Type* TypeVar::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
-    if (auto it = map.find(this); it != map.end())
-        return it->second;
+const Type* TypeVar::replace_uncached(const TypeSubst& subst) const {
+    if (auto type = subst.find(this))
+        return type;
     return this;
 }
 
-const Type* TypeApp::replace(const std::unordered_map<const TypeVar*, const Type*>& map) const {
+const Type* TypeApp::replace_uncached(const TypeSubst& subst) const {
     SmallArray<const Type*> new_type_args(type_args.size());
     for (size_t i = 0, n = type_args.size(); i < n; ++i)
-        new_type_args[i] = type_args[i]->replace(map);
+        new_type_args[i] = type_args[i]->replace(subst);
     return type_table.type_app(applied, std::move(new_type_args));
 }
 
@@ -293,29 +303,46 @@ size_t TypeApp::order(std::unordered_set<const Type*>& seen) const {
     return max_order;
 }
 
+size_t Type::order() const {
+    return type_table.order(this);
+}
+
 // Variance ------------------------------------------------------------------------
 
-void Type::variance(std::unordered_map<const TypeVar*, TypeVariance>&, bool) const {}
+TypeVarMap<TypeVariance> Type::variance(bool dir) const {
+    auto vars = type_table.variance(this);
+    if (!dir) {
+        for (auto& var : vars) {
+            if (var.second == TypeVariance::Covariant)
+                var.second = TypeVariance::Contravariant;
+            else if (var.second == TypeVariance::Contravariant)
+                var.second = TypeVariance::Covariant;
+        }
+    }
+    return vars;
+}
+
+void Type::variance(TypeVarMap<TypeVariance>&, bool) const {}
 
-void TupleType::variance(std::unordered_map<const TypeVar*, TypeVariance>& vars, bool dir) const {
+void TupleType::variance(TypeVarMap<TypeVariance>& vars, bool dir) const {
     for (auto arg : args)
         arg->variance(vars, dir);
 }
 
-void ArrayType::variance(std::unordered_map<const TypeVar*, TypeVariance>& vars, bool dir) const {
+void ArrayType::variance(TypeVarMap<TypeVariance>& vars, bool dir) const {
     elem->variance(vars, dir);
 }
 
-void AddrType::variance(std::unordered_map<const TypeVar*, TypeVariance>& vars, bool dir) const {
+void AddrType::variance(TypeVarMap<TypeVariance>& vars, bool dir) const {
     pointee->variance(vars, dir);
 }
 
-void FnType::variance(std::unordered_map<const TypeVar*, TypeVariance>& vars, bool dir) const {
+void FnType::variance(TypeVarMap<TypeVariance>& vars, bool dir) const {
     dom->variance(vars, !dir);
     codom->variance(vars, dir);
 }
 
-void TypeVar::variance(std::unordered_map<const TypeVar*, TypeVariance>& vars, bool dir) const {
+void TypeVar::variance(TypeVarMap<TypeVariance>& vars, bool dir) const {
     if (auto it = vars.find(this); it != vars.end()) {
         bool var_dir = it->second == TypeVariance::Covariant ? true : false;
         if (var_dir != dir)
@@ -324,40 +351,40 @@ void TypeVar::variance(std::unordered_map<const TypeVar*, TypeVariance>& vars, b
         vars.emplace(this, dir ? TypeVariance::Covariant : TypeVariance::Contravariant);
 }
 
-void TypeApp::variance(std::unordered_map<const TypeVar*, TypeVariance>& vars, bool dir) const {
+void TypeApp::variance(TypeVarMap<TypeVariance>& vars, bool dir) const {
     for (auto type_arg : type_args)
         type_arg->variance(vars, dir);
 }
 
 // Bounds --------------------------------------------------------------------------
 
-void Type::bounds(std::unordered_map<const TypeVar*, TypeBounds>&, const Type*, bool) const {}
+void Type::bounds(TypeVarMap<TypeBounds>&, const Type*, bool) const {}
 
-void TupleType::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, const Type* type, bool dir) const {
+void TupleType::bounds(TypeVarMap<TypeBounds>& bounds, const Type* type, bool dir) const {
     if (auto tuple_type = type->isa<TupleType>()) {
         for (size_t i = 0, n = std::min(args.size(), tuple_type->args.size()); i < n; ++i)
             args[i]->bounds(bounds, tuple_type->args[i], dir);
     }
 }
 
-void ArrayType::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, const Type* type, bool dir) const {
+void ArrayType::bounds(TypeVarMap<TypeBounds>& bounds, const Type* type, bool dir) const {
     if (auto array_type = type->isa<ArrayType>())
         elem->bounds(bounds, array_type->elem, dir);
 }
 
-void AddrType::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, const Type* type, bool dir) const {
+void AddrType::bounds(TypeVarMap<TypeBounds>& bounds, const Type* type, bool dir) const {
     if (auto addr_type = type->isa<AddrType>())
         pointee->bounds(bounds, addr_type->pointee, dir);
 }
 
-void FnType::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, const Type* type, bool dir) const {
+void FnType::bounds(TypeVarMap<TypeBounds>& bounds, const Type* type, bool dir) const {
     if (auto fn_type = type->isa<FnType>()) {
         dom->bounds(bounds, fn_type->dom, !dir);
         codom->bounds(bounds, fn_type->codom, dir);
     }
 }
 
-void TypeVar::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, const Type* type, bool dir) const {
+void TypeVar::bounds(TypeVarMap<TypeBounds>& bounds, const Type* type, bool dir) const {
     TypeBounds type_bounds;
     if (dir)
         type_bounds = TypeBounds { type, type_table.top_type() };
@@ -370,7 +397,7 @@ void TypeVar::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, con
         bounds[this] = type_bounds;
 }
 
-void TypeApp::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, const Type* type, bool dir) const {
+void TypeApp::bounds(TypeVarMap<TypeBounds>& bounds, const Type* type, bool dir) const {
     if (auto type_app = type->isa<TypeApp>()) {
         for (size_t i = 0, n = std::min(type_args.size(), type_app->type_args.size()); i < n; ++i)
             type_args[i]->bounds(bounds, type_app->type_args[i], dir);
@@ -379,6 +406,10 @@ void TypeApp::bounds(std::unordered_map<const TypeVar*, TypeBounds>& bounds, con
 
 // Size ----------------------------------------------------------------------------
 
+bool Type::is_sized() const {
+    return type_table.is_sized(this);
+}
+
 bool Type::is_sized(std::unordered_set<const Type*>&) const {
     return true;
 }
@@ -430,11 +461,11 @@ const ast::TypeParamList* StructType::type_params() const {
         : decl.as<ast::OptionDecl>()->parent->type_params.get();
 }
 
-std::optional<size_t> StructType::find_member(const std::string_view& name) const {
+std::optional<size_t> StructType::find_member(Name name) const {
     auto it = std::find_if(
         decl.fields.begin(),
         decl.fields.end(),
-        [&name] (auto& f) {
+        [name] (auto& f) {
             return f->id.name == name;
         });
     return it != decl.fields.end()
@@ -450,11 +481,11 @@ size_t StructType::member_count() const {
     return decl.fields.size();
 }
 
-std::optional<size_t> EnumType::find_member(const std::string_view& name) const {
+std::optional<size_t> EnumType::find_member(Name name) const {
     auto it = std::find_if(
         decl.options.begin(),
         decl.options.end(),
-        [&name] (auto& o) {
+        [name] (auto& o) {
             return o->id.name == name;
         });
     return it != decl.options.end()
@@ -470,37 +501,40 @@ size_t EnumType::member_count() const {
     return decl.options.size();
 }
 
-std::optional<size_t> ModType::find_member(const std::string_view& name) const {
-    auto it = std::find_if(
-        members().begin(),
-        members().end(),
-        [&name] (auto& member) { return member.name == name; });
-    return it != members().end()
-        ? std::make_optional(it - members().begin())
-        : std::nullopt;
+std::optional<size_t> ModType::find_member(Name name) const {
+    auto& indices = members().indices;
+    auto it = indices.find(name);
+    return it != indices.end() ? std::make_optional(it->second) : std::nullopt;
 }
 
 const Type* ModType::member_type(size_t i) const {
-    return members()[i].decl.type;
+    return members().decls[i]->type;
 }
 
 size_t ModType::member_count() const {
-    return members().size();
+    return members().decls.size();
 }
 
-const ast::NamedDecl& ModType::member(size_t i) const {
-    return members()[i].decl;
+ast::NamedDecl& ModType::member(size_t i) const {
+    return *members().decls[i];
 }
 
 const ModType::Members& ModType::members() const {
-    if (!members_) {
-        members_ = std::make_unique<ModType::Members>();
+    auto members = members_.load(std::memory_order_acquire);
+    if (!members) {
+        auto new_members = new Members();
         for (auto& decl : decl.decls) {
-            if (auto named_decl = decl->isa<ast::NamedDecl>())
-                members_->emplace_back(named_decl->id.name, *named_decl);
+            if (auto named_decl = decl->isa<ast::NamedDecl>()) {
+                new_members->indices.emplace(named_decl->id.name, new_members->decls.size());
+                new_members->decls.push_back(named_decl);
+            }
         }
+        if (members_.compare_exchange_strong(members, new_members, std::memory_order_acq_rel))
+            members = new_members;
+        else
+            delete new_members;
     }
-    return *members_;
+    return *members;
 }
 
 // Misc. ---------------------------------------------------------------------------
@@ -568,24 +602,57 @@ const Type* Type::join(const Type* other) const {
 }
 
 const Type* ForallType::instantiate(const ArrayRef<const Type*>& args) const {
-    std::unordered_map<const TypeVar*, const Type*> map;
-    assert(decl.type_params && decl.type_params->params.size() == args.size());
-    for (size_t i = 0, n = args.size(); i < n; ++i) {
-        assert(decl.type_params->params[i]->type);
-        map.emplace(decl.type_params->params[i]->type->as<TypeVar>(), args[i]); 
-    }
-    return body->replace(map);
+    assert(decl.type_params);
+    return body->replace(type_table.subst(*decl.type_params, args));
 }
 
 bool StructType::is_tuple_like() const {
     return decl.isa<ast::StructDecl>() && decl.as<ast::StructDecl>()->is_tuple_like;
 }
 
-std::unordered_map<const TypeVar*, const Type*> TypeApp::replace_map(
+const TypeSubst& TypeApp::replace_subst() const {
+    // Substitutions are unique, so threads racing to set this store the same value
+    auto subst = replace_subst_.load(std::memory_order_acquire);
+    if (!subst) {
+        assert(applied->type_params());
+        subst = &type_table.subst(*applied->type_params(), type_args);
+        replace_subst_.store(subst, std::memory_order_release);
+    }
+    return *subst;
+}
+
+const Type* TypeApp::member_type(size_t i) const {
+    auto member_types = member_types_.load(std::memory_order_acquire);
+    if (!member_types) {
+        auto new_member_types = new std::atomic<const Type*>[applied->as<ComplexType>()->member_count()]();
+        if (member_types_.compare_exchange_strong(member_types, new_member_types, std::memory_order_acq_rel))
+            member_types = new_member_types;
+        else
+            delete[] new_member_types;
+    }
+    if (auto member_type = member_types[i].load(std::memory_order_acquire))
+        return member_type;
+    // Member types are only cached once they are known,
+    // since they may be queried while the applied type is being checked.
+    auto member = applied->as<ComplexType>()->member_type(i);
+    if (!member)
+        return nullptr;
+    auto member_type = member->replace(replace_subst());
+    member_types[i].store(member_type, std::memory_order_release);
+    return member_type;
+}
+
+const Type* TypeSubst::find(const TypeVar* var) const {
+    auto it = std::lower_bound(pairs.begin(), pairs.end(), var,
+        [] (const Pair& pair, const TypeVar* var) { return pair.first < var; });
+    return it != pairs.end() && it->first == var ? it->second : nullptr;
+}
+
+TypeVarMap<const Type*> TypeApp::replace_map(
     const ast::TypeParamList& type_params,
     const ArrayRef<const Type*>& type_args)
 {
-    std::unordered_map<const TypeVar*, const Type*> map;
+    TypeVarMap<const Type*> map;
     assert(type_params.params.size() == type_args.size());
     for (size_t i = 0, n = type_args.size(); i < n; ++i) {
         assert(type_params.params[i]->type);
@@ -647,9 +714,79 @@ bool is_unit_type(const Type* type) {
 
 // Type table ----------------------------------------------------------------------
 
+TypeTable::TypeTable() {
+    // Singletons are created up front, so that reading them does not require synchronization
+    bool_type_   = prim_type(ast::PrimType::Bool);
+    unit_type_   = tuple_type({});
+    bottom_type_ = insert<BottomType>();
+    top_type_    = insert<TopType>();
+    no_ret_type_ = insert<NoRetType>();
+    type_error_  = insert<TypeError>();
+}
+
 TypeTable::~TypeTable() {
-    for (auto t : types_)
-        delete t;
+    // The memory is released by the arenas, but some types own additional data
+    for (auto& shard : type_shards_)
+        shard.types.for_each([] (const Type* type) { type->~Type(); });
+    substs_.for_each([] (const TypeSubst* subst) { subst->~TypeSubst(); });
+}
+
+template <typename T, typename F>
+const T& TypeTable::info(const Type* type, std::optional<T> TypeInfo::* field, F&& compute) {
+    auto& shard = cache_shards_[shard_index(type->hash())];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (auto it = shard.infos.find(type); it != shard.infos.end() && it->second.*field)
+            return *(it->second.*field);
+    }
+    // The lock is not held during the computation, which may query other types
+    auto value = compute();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& result = shard.infos[type].*field;
+    if (!result)
+        result = std::move(value);
+    return *result;
+}
+
+const TypeVarMap<TypeVariance>& TypeTable::variance(const Type* type) {
+    return info(type, &TypeInfo::variance, [&] {
+        TypeVarMap<TypeVariance> vars;
+        type->variance(vars, true);
+        return vars;
+    });
+}
+
+size_t TypeTable::order(const Type* type) {
+    return info(type, &TypeInfo::order, [&] {
+        std::unordered_set<const Type*> seen;
+        return type->order(seen);
+    });
+}
+
+bool TypeTable::is_sized(const Type* type) {
+    return info(type, &TypeInfo::is_sized, [&] {
+        std::unordered_set<const Type*> seen;
+        return type->is_sized(seen);
+    });
+}
+
+size_t TypeTable::type_count() const {
+    size_t count = 0;
+    for (auto& shard : type_shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.types.size();
+    }
+    return count;
+}
+
+size_t TypeTable::memory_usage() const {
+    size_t memory = 0;
+    for (auto& shard : type_shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        memory += shard.arena.capacity() + shard.types.memory_usage();
+    }
+    std::lock_guard<std::mutex> lock(subst_mutex_);
+    return memory + subst_arena_.capacity() + substs_.memory_usage();
 }
 
 const PrimType* TypeTable::prim_type(ast::PrimType::Tag tag) {
@@ -657,11 +794,11 @@ const PrimType* TypeTable::prim_type(ast::PrimType::Tag tag) {
 }
 
 const PrimType* TypeTable::bool_type() {
-    return prim_type(ast::PrimType::Bool);
+    return bool_type_;
 }
 
 const TupleType* TypeTable::unit_type() {
-    return unit_type_ ? unit_type_ : unit_type_ = tuple_type({});
+    return unit_type_;
 }
 
 const TupleType* TypeTable::tuple_type(const ArrayRef<const Type*>& elems) {
@@ -693,19 +830,19 @@ const FnType* TypeTable::cn_type(const Type* dom) {
 }
 
 const BottomType* TypeTable::bottom_type() {
-    return bottom_type_ ? bottom_type_ : bottom_type_ = insert<BottomType>();
+    return bottom_type_;
 }
 
 const TopType* TypeTable::top_type() {
-    return top_type_ ? top_type_ : top_type_ = insert<TopType>();
+    return top_type_;
 }
 
 const NoRetType* TypeTable::no_ret_type() {
-    return no_ret_type_ ? no_ret_type_ : no_ret_type_ = insert<NoRetType>();
+    return no_ret_type_;
 }
 
 const TypeError* TypeTable::type_error() {
-    return type_error_ ? type_error_ : type_error_ = insert<TypeError>();
+    return type_error_;
 }
 
 const TypeVar* TypeTable::type_var(const ast::TypeParam& param) {
@@ -735,19 +872,67 @@ const TypeAlias* TypeTable::type_alias(const ast::TypeDecl& decl) {
 const Type* TypeTable::type_app(const UserType* applied, const ArrayRef<const Type*>& type_args) {
     if (auto type_alias = applied->isa<TypeAlias>()) {
         assert(type_alias->type_params() && type_alias->decl.aliased_type->type);
-        auto map = TypeApp::replace_map(*type_alias->type_params(), type_args);
-        return type_alias->decl.aliased_type->type->replace(map);
+        return type_alias->decl.aliased_type->type->replace(subst(*type_alias->type_params(), type_args));
     }
     return insert<TypeApp>(applied, std::move(type_args));
 }
 
+const TypeSubst& TypeTable::subst(const TypeVarMap<const Type*>& map) {
+    SmallArray<TypeSubst::Pair> pairs(map.size());
+    std::copy(map.begin(), map.end(), pairs.begin());
+    return insert_subst(pairs);
+}
+
+const TypeSubst& TypeTable::subst(const ast::TypeParamList& type_params, const ArrayRef<const Type*>& type_args) {
+    assert(type_params.params.size() == type_args.size());
+    SmallArray<TypeSubst::Pair> pairs(type_args.size());
+    for (size_t i = 0, n = type_args.size(); i < n; ++i) {
+        assert(type_params.params[i]->type);
+        pairs[i] = std::make_pair(type_params.params[i]->type->as<TypeVar>(), type_args[i]);
+    }
+    return insert_subst(pairs);
+}
+
+const TypeSubst& TypeTable::insert_subst(SmallArray<TypeSubst::Pair>& pairs) {
+    std::sort(pairs.begin(), pairs.end(), [] (auto& left, auto& right) { return left.first < right.first; });
+    auto hash = fnv::Hash();
+    for (auto& pair : pairs)
+        hash.combine(pair.first->hash()).combine(pair.second->hash());
+
+    TypeSubst subst { Array<TypeSubst::Pair>(pairs), hash };
+    std::lock_guard<std::mutex> lock(subst_mutex_);
+    if (auto found = substs_.find(&subst))
+        return *found;
+    return *substs_.insert(new (subst_arena_.alloc(sizeof(TypeSubst), alignof(TypeSubst))) TypeSubst(std::move(subst)));
+}
+
+const Type* TypeTable::replace(const Type* type, const TypeSubst& subst) {
+    if (subst.empty())
+        return type;
+    auto key = std::make_pair(type, &subst);
+    auto& shard = cache_shards_[shard_index(type->hash())];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (auto it = shard.replacements.find(key); it != shard.replacements.end())
+            return it->second;
+    }
+    // The lock is not held while the elements of the type are replaced. If several threads
+    // replace the same type at once, they all obtain the same, hash-consed result.
+    auto result = type->replace_uncached(subst);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.replacements.emplace(key, result);
+    return result;
+}
+
 template <typename T, typename... Args>
 const T* TypeTable::insert(Args&&... args) {
     T t(*this, std::forward<Args>(args)...);
-    if (auto it = types_.find(&t); it != types_.end())
-        return (*it)->template as<T>();
-    auto [it, _] = types_.emplace(new T(std::move(t)));
-    return (*it)->template as<T>();
+    t.hash_ = t.compute_hash();
+    auto& shard = type_shards_[shard_index(t.hash_)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (auto found = shard.types.find(&t))
+        return found->template as<T>();
+    return shard.types.insert(new (shard.arena.alloc(sizeof(T), alignof(T))) T(std::move(t)))->template as<T>();
 }
 
 } // namespace artic
@@ -0,0 +1,12 @@
+# Checks that the AST of a file is printed in the same way, and produces the
+# same diagnostics, after it has been serialized and read back. TEST_ARGS holds
+# additional options for the compiler, separated by spaces.
+separate_arguments(args UNIX_COMMAND "${TEST_ARGS}")
+execute_process(COMMAND ${TEST_EXECUTABLE} ${args} --print-ast ${TEST_SOURCE_FILE} OUTPUT_VARIABLE expected_out ERROR_VARIABLE expected_err RESULT_VARIABLE expected_status)
+execute_process(COMMAND ${TEST_EXECUTABLE} ${args} --print-ast --round-trip-ast ${TEST_SOURCE_FILE} OUTPUT_VARIABLE out ERROR_VARIABLE err RESULT_VARIABLE status)
+if (NOT status STREQUAL expected_status)
+    message(FATAL_ERROR "Exit status differs after serialization: ${status} instead of ${expected_status}")
+endif ()
+if (NOT out STREQUAL expected_out OR NOT err STREQUAL expected_err)
+    message(FATAL_ERROR "Output differs after serialization:\n${out}${err}")
+endif ()
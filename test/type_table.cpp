@@ -0,0 +1,98 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+#include "artic/parser.h"
+#include "artic/bind.h"
+#include "artic/check.h"
+#include "artic/log.h"
+
+using namespace artic;
+
+// Stress test for the type table: Several threads create the same types at the same time,
+// each in a different order, and must all obtain exactly the same pointers.
+
+static constexpr std::string_view source =
+    "struct S[T] { x: T, y: (T, i32) }\n"
+    "enum E[T, U] { A(T), B(U) }\n";
+
+struct Builder {
+    TypeTable& type_table;
+    const StructType* struct_type;
+    const EnumType* enum_type;
+
+    // Builds the i-th type of the sequence, by nesting tuples, functions, and type applications
+    const Type* build(size_t i) const {
+        static const ast::PrimType::Tag tags[] = {
+            ast::PrimType::I32, ast::PrimType::I64, ast::PrimType::F32, ast::PrimType::Bool
+        };
+        auto prim = type_table.prim_type(tags[i % 4]);
+        const Type* type = type_table.sized_array_type(type_table.prim_type(tags[(i / 4) % 4]), i / 16, false);
+        for (size_t j = 0, depth = 1 + i % 7; j < depth; ++j) {
+            const Type* args[] = { prim, type };
+            switch ((i / 16 + j) % 5) {
+                case 0: type = type_table.tuple_type(args); break;
+                case 1: type = type_table.fn_type(prim, type); break;
+                case 2: type = type_table.type_app(struct_type, type); break;
+                case 3: type = type_table.type_app(enum_type, args); break;
+                default: type = type_table.ptr_type(type, j % 2 == 0, 0); break;
+            }
+            // Exercise the caches of type applications as well
+            if (auto type_app = type->isa<TypeApp>())
+                type_app->member_type(1);
+        }
+        return type;
+    }
+};
+
+int main(int argc, char** argv) {
+    size_t thread_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8;
+    size_t type_count   = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+
+    Log log(log::err);
+    Lexer lexer(log, 0, source);
+    Parser parser(log, lexer);
+    auto program = parser.parse();
+    TypeTable type_table;
+    NameBinder name_binder(log);
+    TypeChecker type_checker(log, type_table);
+    if (log.errors > 0 || !name_binder.run(*program) || !type_checker.run(*program))
+        return EXIT_FAILURE;
+
+    Builder builder {
+        type_table,
+        program->decls[0]->type->as<StructType>(),
+        program->decls[1]->type->as<EnumType>()
+    };
+
+    std::atomic<bool> start(false);
+    std::vector<std::vector<const Type*>> results(thread_count, std::vector<const Type*>(type_count));
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+            while (!start.load()) std::this_thread::yield();
+            // Each thread starts at a different position in the sequence
+            for (size_t j = 0; j < type_count; ++j) {
+                auto k = (j + i * type_count / thread_count) % type_count;
+                results[i][k] = builder.build(k);
+            }
+        });
+    }
+    start.store(true);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t j = 0; j < type_count; ++j) {
+        auto type = builder.build(j);
+        for (size_t i = 0; i < thread_count; ++i) {
+            if (results[i][j] != type) {
+                log::error("type {} differs between threads", j);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    std::cout << thread_count << " thread(s), " << type_table.type_count() << " type(s)\n";
+    return EXIT_SUCCESS;
+}